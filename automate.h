@@ -0,0 +1,67 @@
+// Genere par generateur_automate a partir de jetons.def : ne pas modifier.
+// 103 etats non deterministes, 23 deterministes, 18 apres minimisation.
+// Etats : 0=-, 1=OPERATEUR/TERM_DIV, 2=OPERATEUR/TERM_MULT, 3=IDENTIFIER/TERM_N, 4=NOMBRE/TERM_N, 5=OPERATEUR/TERM_PLUS, 6=OPERATEUR/TERM_MOINS, 7=DELIMITEUR/TERM_PAREN_OPEN, 8=DELIMITEUR/TERM_PAREN_CLOSE, 9=DELIMITEUR/TERM_END, 10=AFECTATION/TERM_AFFECTATION, 11=COMPARATEUR/TERM_INF, 12=COMPARATEUR/TERM_SUP, 13=(ignore), 14=COMPARATEUR/TERM_EGAL, 15=COMPARATEUR/TERM_INF_EGAL, 16=COMPARATEUR/TERM_SUP_EGAL, 17=(ignore)
+
+#define NB_ETATS_AUTOMATE 18
+#define ETAT_INITIAL 0
+#define ETAT_CORPS_COMMENTAIRE 13 // -1 : aucun
+#define ETATS_IGNORES 0x22000ull // états au milieu d'une règle IGNORER
+
+static const LexemeType typeEtatAutomate[NB_ETATS_AUTOMATE] = {UNKNOWN, OPERATEUR, OPERATEUR, IDENTIFIER, NOMBRE, OPERATEUR, OPERATEUR, DELIMITEUR, DELIMITEUR, DELIMITEUR, AFECTATION, COMPARATEUR, COMPARATEUR, UNKNOWN, COMPARATEUR, COMPARATEUR, COMPARATEUR, UNKNOWN};
+
+static const Terminal terminalEtatAutomate[NB_ETATS_AUTOMATE] = {TERM_ERREUR, TERM_DIV, TERM_MULT, TERM_N, TERM_N, TERM_PLUS, TERM_MOINS, TERM_PAREN_OPEN, TERM_PAREN_CLOSE, TERM_END, TERM_AFFECTATION, TERM_INF, TERM_SUP, TERM_ERREUR, TERM_EGAL, TERM_INF_EGAL, TERM_SUP_EGAL, TERM_ERREUR};
+
+static const int lignesAutomate[NB_ETATS_AUTOMATE + 1] = {0, 79, 80, 80, 142, 152, 152, 152, 152, 152, 152, 153, 154, 155, 410, 410, 410, 410, 665};
+
+static const unsigned char colonnesAutomate[665] = {
+    32,9,10,13,47,42,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,
+    115,116,117,118,119,120,121,122,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,
+    81,82,83,84,85,86,87,88,89,90,48,49,50,51,52,53,54,55,56,57,43,45,40,41,
+    59,44,123,125,61,60,62,42,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,
+    113,114,115,116,117,118,119,120,121,122,65,66,67,68,69,70,71,72,73,74,75,76,77,78,
+    79,80,81,82,83,84,85,86,87,88,89,90,48,49,50,51,52,53,54,55,56,57,48,49,
+    50,51,52,53,54,55,56,57,61,61,61,32,9,10,13,47,42,97,98,99,100,101,102,103,
+    104,105,106,107,108,109,110,111,112,113,114,115,116,117,118,119,120,121,122,65,66,67,68,69,
+    70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,48,49,50,
+    51,52,53,54,55,56,57,43,45,40,41,59,44,123,125,61,60,62,1,2,3,4,5,6,
+    7,8,11,12,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,33,34,
+    35,36,37,38,39,46,58,63,64,91,92,93,94,95,96,124,126,127,128,129,130,131,132,133,
+    134,135,136,137,138,139,140,141,142,143,144,145,146,147,148,149,150,151,152,153,154,155,156,157,
+    158,159,160,161,162,163,164,165,166,167,168,169,170,171,172,173,174,175,176,177,178,179,180,181,
+    182,183,184,185,186,187,188,189,190,191,192,193,194,195,196,197,198,199,200,201,202,203,204,205,
+    206,207,208,209,210,211,212,213,214,215,216,217,218,219,220,221,222,223,224,225,226,227,228,229,
+    230,231,232,233,234,235,236,237,238,239,240,241,242,243,244,245,246,247,248,249,250,251,252,253,
+    254,255,32,9,10,13,47,42,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,
+    113,114,115,116,117,118,119,120,121,122,65,66,67,68,69,70,71,72,73,74,75,76,77,78,
+    79,80,81,82,83,84,85,86,87,88,89,90,48,49,50,51,52,53,54,55,56,57,43,45,
+    40,41,59,44,123,125,61,60,62,1,2,3,4,5,6,7,8,11,12,14,15,16,17,18,
+    19,20,21,22,23,24,25,26,27,28,29,30,31,33,34,35,36,37,38,39,46,58,63,64,
+    91,92,93,94,95,96,124,126,127,128,129,130,131,132,133,134,135,136,137,138,139,140,141,142,
+    143,144,145,146,147,148,149,150,151,152,153,154,155,156,157,158,159,160,161,162,163,164,165,166,
+    167,168,169,170,171,172,173,174,175,176,177,178,179,180,181,182,183,184,185,186,187,188,189,190,
+    191,192,193,194,195,196,197,198,199,200,201,202,203,204,205,206,207,208,209,210,211,212,213,214,
+    215,216,217,218,219,220,221,222,223,224,225,226,227,228,229,230,231,232,233,234,235,236,237,238,
+    239,240,241,242,243,244,245,246,247,248,249,250,251,252,253,254,255};
+
+static const signed char ciblesAutomate[665] = {
+    0,0,0,0,1,2,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,
+    3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,4,4,4,4,4,4,
+    4,4,4,4,5,6,7,8,9,9,9,9,10,11,12,13,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,
+    3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,
+    3,3,3,3,3,3,3,3,3,3,3,3,3,3,4,4,4,4,4,4,4,4,4,4,14,15,16,13,13,13,13,13,
+    17,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,0,17,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,
+    13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13,13};
@@ -3,12 +3,36 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <time.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
-#define MAX_STATES 20
-#define MAX_TRANSITIONS 2000
-#define MAX_LEXEME_LENGTH 100
-#define MAX_SYMBOL_TABLE_SIZE 97
+#define TAILLE_TS_INITIALE 64 // puissance de 2
 #define END_SYMBOL -1
+#define NB_OCTETS 256
+#define MAX_CLASSES 64
+#define TAILLE_FENETRE (64 * 1024)
 typedef enum
 {
     IDENTIFIER,
@@ -21,33 +45,97 @@ typedef enum
     UNKNOWN
 } LexemeType;
 
+typedef enum
+{
+    TERM_N,           // n (repre sente un nombre ou un identificateur)
+    TERM_PLUS,        // +
+    TERM_MULT,        // *
+    TERM_PAREN_OPEN,  // (
+    TERM_PAREN_CLOSE, // )
+    TERM_END,         // $
+    // Opérateurs reconnus seulement par le moteur Pratt (pas de production LL(1))
+    TERM_MOINS,       // -
+    TERM_DIV,         // /
+    TERM_MOD,         // mod
+    TERM_INF,         // <
+    TERM_INF_EGAL,    // <=
+    TERM_SUP,         // >
+    TERM_SUP_EGAL,    // >=
+    TERM_EGAL,        // ==
+    TERM_AFFECTATION, // =
+    // Lexème non reconnu ou mot clé hors grammaire : aucun moteur ne l'accepte
+    TERM_ERREUR,
+    NB_TERMINAUX
+} Terminal;
+
+// Automate du lexeur, généré à la compilation depuis jetons.def (make automate.h)
+#include "automate.h"
+#define MAX_STATES NB_ETATS_AUTOMATE
+
+// Table de transitions compilée : chaque octet est ramené à une classe d'équivalence
+// (octets ayant la même colonne dans la matrice CSR), puis suivant[etat][classe]
+typedef struct
+{
+    unsigned char classe[NB_OCTETS];
+    int nbClasses;
+    signed char suivant[MAX_STATES][MAX_CLASSES]; // -1 = pas de transition
+} TableDense;
+
+// Matrice CSR de l'automate : les lignes pointent dans les tables générées
 typedef struct
 {
-    int row_ptr[MAX_STATES + 1];
-    int col_ind[MAX_TRANSITIONS];
-    int values[MAX_TRANSITIONS];
+    const int *row_ptr;
+    const unsigned char *col_ind;
+    const signed char *values;
+    bool modeDense; // true : chercherEtatSuivant utilise la table dense
+    TableDense dense;
 } CSRmatrice;
 
-// Structure pour une entrée dans la table des symboles
+// Structure pour une entrée dans la table des symboles ; l'indice de l'entrée est
+// l'identifiant (stable) du symbole
 typedef struct
 {
-    char lexeme[MAX_LEXEME_LENGTH];
-    LexemeType type;
+    uint64_t hash;
+    uint64_t offset;   // position du lexème dans l'arène de la table
+    int64_t valeur;    // NOMBRE : valeur du littéral (INT64_MAX s'il déborde)
+    uint32_t longueur; // sans le '\0' final
+    uint8_t type;      // LexemeType
+    bool debordement;  // NOMBRE : le littéral dépasse INT64_MAX
 } SymbolEntry;
 
-// Table des symboles
+// Case de l'index à adressage ouvert (sondage linéaire)
 typedef struct
 {
-    SymbolEntry entries[MAX_SYMBOL_TABLE_SIZE];
-    int size;
-} TS;
+    uint32_t empreinte; // 32 bits de poids fort du hash
+    int32_t id;         // -1 : case vide
+} CaseTS;
+
+// Zones mémoire d'une table des symboles (sections d'un instantané)
+enum
+{
+    ZONE_ENTREES,
+    ZONE_CASES,
+    ZONE_ARENE,
+    NB_ZONES_TS
+};
 
-// Structure pour un lexème
+// Table des symboles : index qui grandit par doublement, entrées dans l'ordre
+// d'insertion et textes contigus dans une arène
 typedef struct
 {
-    char lexeme[MAX_LEXEME_LENGTH];
-    LexemeType type;
-} Lexeme;
+    SymbolEntry *entries;
+    int size;
+    int capaciteEntrees;
+    CaseTS *cases;
+    uint32_t masque; // nombre de cases - 1
+    char *arene;
+    size_t tailleArene;
+    size_t capaciteArene;
+    // Zones projetées depuis un instantané (NULL : zone allouée dans le tas)
+    void *projections[NB_ZONES_TS];
+    size_t taillesProjections[NB_ZONES_TS];
+} TS;
+
 typedef enum
 {
     NT_E,      // E
@@ -56,15 +144,6 @@ typedef enum
     NT_TPRIME, // T'
     NT_F       // F
 } NonTerminal;
-typedef enum
-{
-    TERM_N,           // n (repre sente un nombre ou un identificateur)
-    TERM_PLUS,        // +
-    TERM_MULT,        // *
-    TERM_PAREN_OPEN,  // (
-    TERM_PAREN_CLOSE, // )
-    TERM_END          // $
-} Terminal;
 // Definition des productions
 typedef enum
 {
@@ -79,122 +158,178 @@ typedef enum
     PROD_ERROR           // Production d'erreur
 } Production;
 
-Production parseTable[5][6] = {
-    // n      +       *       (       )       $
-    {PROD_E_TE, PROD_ERROR, PROD_ERROR, PROD_E_TE, PROD_ERROR, PROD_ERROR},                                       // NT_E
-    {PROD_ERROR, PROD_EPRIME_PLUS_TE, PROD_ERROR, PROD_ERROR, PROD_EPRIME_EPSILON, PROD_EPRIME_EPSILON},          // NT_EPRIME
-    {PROD_T_FT, PROD_ERROR, PROD_ERROR, PROD_T_FT, PROD_ERROR, PROD_ERROR},                                       // NT_T
-    {PROD_ERROR, PROD_TPRIME_EPSILON, PROD_TPRIME_MULT_FT, PROD_ERROR, PROD_TPRIME_EPSILON, PROD_TPRIME_EPSILON}, // NT_TPRIME
-    {PROD_F_N, PROD_ERROR, PROD_ERROR, PROD_F_PAREN_E, PROD_ERROR, PROD_ERROR}                                    // NT_F
+// Colonnes des terminaux TERM_MOINS à TERM_ERREUR
+#define HORS_GRAMMAIRE_LL1 \
+    PROD_ERROR, PROD_ERROR, PROD_ERROR, PROD_ERROR, PROD_ERROR, PROD_ERROR, PROD_ERROR, PROD_ERROR, PROD_ERROR, PROD_ERROR
+
+Production parseTable[5][NB_TERMINAUX] = {
+    // n      +       *       (       )       $       - / mod < <= > >= == = erreur
+    {PROD_E_TE, PROD_ERROR, PROD_ERROR, PROD_E_TE, PROD_ERROR, PROD_ERROR, HORS_GRAMMAIRE_LL1},                                       // NT_E
+    {PROD_ERROR, PROD_EPRIME_PLUS_TE, PROD_ERROR, PROD_ERROR, PROD_EPRIME_EPSILON, PROD_EPRIME_EPSILON, HORS_GRAMMAIRE_LL1},          // NT_EPRIME
+    {PROD_T_FT, PROD_ERROR, PROD_ERROR, PROD_T_FT, PROD_ERROR, PROD_ERROR, HORS_GRAMMAIRE_LL1},                                       // NT_T
+    {PROD_ERROR, PROD_TPRIME_EPSILON, PROD_TPRIME_MULT_FT, PROD_ERROR, PROD_TPRIME_EPSILON, PROD_TPRIME_EPSILON, HORS_GRAMMAIRE_LL1}, // NT_TPRIME
+    {PROD_F_N, PROD_ERROR, PROD_ERROR, PROD_F_PAREN_E, PROD_ERROR, PROD_ERROR, HORS_GRAMMAIRE_LL1}                                    // NT_F
 };
 
-// Structure pour stocker un element de la pile d'analyse
+// --- COMPTEURS ---
+// Compilé avec -DCOMPTEURS, le programme compte ce qui se passe sur les chemins
+// chauds et écrit le tout en JSON sur stderr à la sortie. Sans ce drapeau, COMPTER
+// ne produit aucun code. Les compteurs ne sont pas atomiques : avec plusieurs
+// threads (--lot, --lexeur-parallele), les totaux sont approximatifs.
+#define MAX_SONDAGE 32 // dernière case de l'histogramme : MAX_SONDAGE cases ou plus
+
 typedef struct
 {
-    int isTerminal; // 1 si terminal, 0 si non-terminal
-    union
-    {
-        NonTerminal nt;
-        Terminal terminal;
-    } symbol;
-} StackElement;
+    uint64_t transitions[MAX_STATES]; // transitions prises depuis chaque état
+    uint64_t sautes[MAX_STATES];      // octets avalés par les boucles par bloc (état initial, commentaire)
+    uint64_t rangCSR[MAX_STATES];     // somme des positions de la colonne trouvée dans la ligne CSR
+    uint64_t echecs[MAX_STATES];      // recherches sans transition
+    uint64_t sondagesRecherche[MAX_SONDAGE + 1]; // cases visitées par chercherSymbole
+    uint64_t sondagesAjout[MAX_SONDAGE + 1];     // cases visitées par ajoutSymbole
+    uint64_t agrandissements;
+    double remplissageMax; // symboles / cases, après chaque ajout
+    int symboles;
+    uint32_t cases;
+    uint64_t productions[PROD_ERROR + 1];
+    size_t profondeurPileMax;
+} Compteurs;
+
+#ifdef COMPTEURS
+Compteurs compteurs;
+#define COMPTER(instruction) \
+    do                       \
+    {                        \
+        instruction;         \
+    } while (0)
+#else
+#define COMPTER(instruction) ((void)0)
+#endif
+
+// Noeuds de l'arbre syntaxique ; les opérateurs sont aussi les actions de
+// construction empilées par applyProduction
+typedef enum
+{
+    NOEUD_FEUILLE, // n : identificateur ou nombre
+    NOEUD_PLUS,
+    NOEUD_MULT,
+    // Construits seulement par le moteur Pratt
+    NOEUD_MOINS,
+    NOEUD_DIV,
+    NOEUD_MOD,
+    NOEUD_INF,
+    NOEUD_INF_EGAL,
+    NOEUD_SUP,
+    NOEUD_SUP_EGAL,
+    NOEUD_EGAL,
+    NOEUD_AFFECTATION, // gauche : feuille de l'identificateur affecté
+    NB_TYPES_NOEUDS
+} TypeNoeud;
+
+// Element de la pile d'analyse sur un octet : un terminal tel quel, un
+// non-terminal avec le bit de poids fort, une action (construction d'un noeud)
+// avec le bit 6
+typedef uint8_t StackElement;
+#define NON_TERMINAL(nt) ((StackElement)(0x80 | (nt)))
+#define ACTION(noeud) ((StackElement)(0x40 | (noeud)))
+#define estTerminal(x) ((x) < 0x40)
+#define estAction(x) (((x) & 0xC0) == 0x40)
+#define symboleDe(x) ((x) & 0x3F)
+#define PROFONDEUR_PILE_MAX (64 * 1024 * 1024)
 
-// Structure pour la pile d'analyse
+// Structure pour la pile d'analyse : tableau qui grandit par doublement, jamais
+// au-delà de limite éléments
 typedef struct
 {
-    StackElement elements[100];
-    int top;
+    StackElement *elements;
+    size_t top; // nombre d'éléments
+    size_t capacite;
+    size_t limite;
+    size_t profondeurMax; // plus haut niveau atteint depuis initStack
 } ParseStack;
 
-// Fonctions de manipulation de la pile
-void initStack(ParseStack *stack)
+void creerPile(ParseStack *stack, size_t limite)
 {
-    stack->top = -1;
-
-    // Empiler le symbole de fin ($)
-    StackElement endSymbol;
-    endSymbol.isTerminal = 1;
-    endSymbol.symbol.terminal = TERM_END;
-    stack->elements[++stack->top] = endSymbol;
+    stack->capacite = 64;
+    stack->elements = malloc(stack->capacite);
+    stack->top = 0;
+    stack->limite = limite;
+    stack->profondeurMax = 0;
+}
 
-    // Empiler le symbole de depart (E)
-    StackElement startSymbol;
-    startSymbol.isTerminal = 0;
-    startSymbol.symbol.nt = NT_E;
-    stack->elements[++stack->top] = startSymbol;
+void libererPile(ParseStack *stack)
+{
+    free(stack->elements);
+    stack->elements = NULL;
+    stack->capacite = 0;
 }
 
-void push(ParseStack *stack, StackElement element)
+// Garantit la place pour n éléments de plus ; false si la limite serait dépassée
+bool reserverPile(ParseStack *stack, size_t n)
 {
-    if (stack->top < 99)
+    if (stack->top + n <= stack->capacite)
     {
-        stack->elements[++stack->top] = element;
+        return true;
     }
-    else
+    if (stack->top + n > stack->limite)
     {
-        printf("Erreur: Débordement de pile\n");
+        return false;
     }
-}
-
-StackElement pop(ParseStack *stack)
-{
-    if (stack->top >= 0)
+    while (stack->top + n > stack->capacite)
     {
-        return stack->elements[stack->top--];
+        stack->capacite *= 2;
     }
-    else
+    if (stack->capacite > stack->limite)
     {
-        printf("Erreur: Pile vide\n");
-        StackElement error;
-        error.isTerminal = -1;
-        return error;
+        stack->capacite = stack->limite;
     }
+    stack->elements = realloc(stack->elements, stack->capacite);
+    return true;
 }
 
-StackElement top(ParseStack *stack)
+bool push(ParseStack *stack, StackElement element)
 {
-    if (stack->top >= 0)
+    if (!reserverPile(stack, 1))
     {
-        return stack->elements[stack->top];
+        return false;
     }
-    else
+    stack->elements[stack->top++] = element;
+    if (stack->top > stack->profondeurMax)
     {
-        printf("Erreur: Pile vide\n");
-        StackElement error;
-        error.isTerminal = -1;
-        return error;
+        stack->profondeurMax = stack->top;
+        COMPTER(if (stack->top > compteurs.profondeurPileMax) compteurs.profondeurPileMax = stack->top);
     }
+    return true;
+}
+
+// Fonctions de manipulation de la pile (la pile est vidée, sa mémoire est gardée)
+void initStack(ParseStack *stack)
+{
+    stack->top = 0;
+    stack->profondeurMax = 0;
+
+    // Empiler le symbole de fin ($) puis le symbole de depart (E)
+    push(stack, TERM_END);
+    push(stack, NON_TERMINAL(NT_E));
 }
 
-// Conversion LexemeType vers indice de terminal pour la table d'analyse
-Terminal convertToTerminal(LexemeType type, const char *lexeme)
+StackElement pop(ParseStack *stack)
 {
-    // Si c'est la fin de l'entrée
-    if (type == UNKNOWN && (strcmp(lexeme, "$") == 0 || lexeme[0] == '\0'))
+    if (stack->top > 0)
     {
-        return TERM_END;
+        return stack->elements[--stack->top];
     }
+    printf("Erreur: Pile vide\n");
+    return TERM_END;
+}
 
-    switch (type)
+StackElement top(ParseStack *stack)
+{
+    if (stack->top > 0)
     {
-    case IDENTIFIER:
-    case NOMBRE:
-        return TERM_N; // 'n' représente un nombre ou un identificateur dans la grammaire
-    case OPERATEUR:
-        if (strcmp(lexeme, "+") == 0)
-            return TERM_PLUS;
-        if (strcmp(lexeme, "*") == 0)
-            return TERM_MULT;
-        return TERM_END; // Symbole non reconnu
-    case DELIMITEUR:
-        if (strcmp(lexeme, "(") == 0)
-            return TERM_PAREN_OPEN;
-        if (strcmp(lexeme, ")") == 0)
-            return TERM_PAREN_CLOSE;
-        return TERM_END; // Symbole non reconnu
-    default:
-        return TERM_END; // Symbole non reconnu
+        return stack->elements[stack->top - 1];
     }
+    printf("Erreur: Pile vide\n");
+    return TERM_END;
 }
 
 // Fonction auxiliaire pour afficher les productions
@@ -232,68 +367,52 @@ void printProduction(Production prod)
     }
 }
 
-// Fonction pour appliquer une production et empiler les symboles correspondants
-void applyProduction(ParseStack *stack, Production prod)
+// Fonction pour appliquer une production et empiler les symboles correspondants ;
+// false si la pile atteint sa limite (rien n'est alors empilé). Avec actions, les
+// opérateurs empilent aussi l'action qui construit leur noeud une fois l'opérande
+// droit reconnu.
+bool applyProduction(ParseStack *stack, Production prod, bool actions)
 {
-    StackElement element;
-
+    COMPTER(compteurs.productions[prod]++);
     // Dépiler le non-terminal
     pop(stack);
+    if (!reserverPile(stack, 4))
+    {
+        return false;
+    }
 
     // Empiler les éléments de la production en ordre inversé (droite à gauche)
     switch (prod)
     {
     case PROD_E_TE:
         // E -> T E'
-        element.isTerminal = 0;
-        element.symbol.nt = NT_EPRIME;
-        push(stack, element);
-
-        element.isTerminal = 0;
-        element.symbol.nt = NT_T;
-        push(stack, element);
+        push(stack, NON_TERMINAL(NT_EPRIME));
+        push(stack, NON_TERMINAL(NT_T));
         break;
 
     case PROD_EPRIME_PLUS_TE:
         // E' -> + T E'
-        element.isTerminal = 0;
-        element.symbol.nt = NT_EPRIME;
-        push(stack, element);
-
-        element.isTerminal = 0;
-        element.symbol.nt = NT_T;
-        push(stack, element);
-
-        element.isTerminal = 1;
-        element.symbol.terminal = TERM_PLUS;
-        push(stack, element);
+        push(stack, NON_TERMINAL(NT_EPRIME));
+        if (actions)
+            push(stack, ACTION(NOEUD_PLUS));
+        push(stack, NON_TERMINAL(NT_T));
+        push(stack, TERM_PLUS);
         break;
 
     case PROD_EPRIME_EPSILON: // E' -> ε
         break;
 
     case PROD_T_FT: // T -> F T'
-        element.isTerminal = 0;
-        element.symbol.nt = NT_TPRIME;
-        push(stack, element);
-
-        element.isTerminal = 0;
-        element.symbol.nt = NT_F;
-        push(stack, element);
+        push(stack, NON_TERMINAL(NT_TPRIME));
+        push(stack, NON_TERMINAL(NT_F));
         break;
 
     case PROD_TPRIME_MULT_FT: // T' -> * F T'
-        element.isTerminal = 0;
-        element.symbol.nt = NT_TPRIME;
-        push(stack, element);
-
-        element.isTerminal = 0;
-        element.symbol.nt = NT_F;
-        push(stack, element);
-
-        element.isTerminal = 1;
-        element.symbol.terminal = TERM_MULT;
-        push(stack, element);
+        push(stack, NON_TERMINAL(NT_TPRIME));
+        if (actions)
+            push(stack, ACTION(NOEUD_MULT));
+        push(stack, NON_TERMINAL(NT_F));
+        push(stack, TERM_MULT);
         break;
 
     case PROD_TPRIME_EPSILON:
@@ -302,431 +421,1214 @@ void applyProduction(ParseStack *stack, Production prod)
 
     case PROD_F_PAREN_E:
         // F -> ( E )
-        element.isTerminal = 1;
-        element.symbol.terminal = TERM_PAREN_CLOSE;
-        push(stack, element);
-
-        element.isTerminal = 0;
-        element.symbol.nt = NT_E;
-        push(stack, element);
-
-        element.isTerminal = 1;
-        element.symbol.terminal = TERM_PAREN_OPEN;
-        push(stack, element);
+        push(stack, TERM_PAREN_CLOSE);
+        push(stack, NON_TERMINAL(NT_E));
+        push(stack, TERM_PAREN_OPEN);
         break;
 
     case PROD_F_N:
         // F -> n
-        element.isTerminal = 1;
-        element.symbol.terminal = TERM_N;
-        push(stack, element);
+        push(stack, TERM_N);
         break;
 
     case PROD_ERROR:
         printf("Erreur: Production non définie\n");
         break;
     }
+    return true;
 }
 
-int ajoutSymbole(TS *table, const char *lexeme, LexemeType type);
+int ajoutSymbole(TS *table, const char *lexeme, int longueur, LexemeType type);
 
-int hashFonction(const char lexeme[])
+// Hachage 64 bits des lexèmes (8 octets par multiplication puis mélange final) :
+// les bits de poids faible choisissent la case, ceux de poids fort servent d'empreinte
+uint64_t hashFonction(const char lexeme[], int longueur)
 {
-    int sum = 0;
-    for (int i = 0; lexeme[i] != '\0'; i++)
+    const uint64_t m = 0x9E3779B97F4A7C15ull;
+    uint64_t h = (uint64_t)longueur * m;
+    int i = 0;
+    for (; i + 8 <= longueur; i += 8)
+    {
+        uint64_t mot;
+        memcpy(&mot, lexeme + i, 8);
+        h = (h ^ mot) * m;
+        h ^= h >> 29;
+    }
+    if (i < longueur)
     {
-        sum += lexeme[i] * (i + 1);
+        uint64_t mot = 0;
+        memcpy(&mot, lexeme + i, longueur - i);
+        h = (h ^ mot) * m;
     }
-    return sum % MAX_SYMBOL_TABLE_SIZE;
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ull;
+    h ^= h >> 32;
+    return h;
 }
-void initialiserTS(TS *table)
+
+// Valeur de 8 chiffres ASCII lus comme un mot (petit-boutiste) : SWAR, les paires
+// de chiffres, puis les groupes de 4, sont combinées par multiplication
+static inline uint64_t huitChiffres(const char *texte)
 {
-    table->size = 0;
-    for (int i = 0; i < MAX_SYMBOL_TABLE_SIZE; i++)
+    uint64_t mot;
+    memcpy(&mot, texte, 8);
+    mot -= 0x3030303030303030ull;
+    mot = mot * 10 + (mot >> 8); // octets pairs : valeur des paires
+    const uint64_t masque = 0x000000FF000000FFull;
+    return (((mot & masque) * (100 + (1000000ull << 32))) + (((mot >> 16) & masque) * (1 + (10000ull << 32)))) >>
+           32;
+}
+
+// Valeur d'un littéral décimal (des chiffres seuls, garantis par l'automate) :
+// 8 chiffres à la fois, puis le reste un par un. Renvoie false en cas de
+// dépassement, *valeur vaut alors INT64_MAX (comme strtoll).
+bool convertirNombre(const char *texte, int longueur, int64_t *valeur)
+{
+    int i = 0;
+    while (i < longueur && texte[i] == '0')
+        i++;
+    // Au plus 19 chiffres significatifs : moins de 10^19, pas de débordement sur 64 bits
+    if (longueur - i > 19)
+    {
+        *valeur = INT64_MAX;
+        return false;
+    }
+    uint64_t v = 0;
+    for (; i + 8 <= longueur; i += 8)
+        v = v * 100000000 + huitChiffres(texte + i);
+    for (; i < longueur; i++)
+        v = v * 10 + (uint64_t)(texte[i] - '0');
+    if (v > INT64_MAX)
     {
-        table->entries[i].lexeme[0] = '\0';
+        *valeur = INT64_MAX;
+        return false;
     }
+    *valeur = (int64_t)v;
+    return true;
+}
 
-    ajoutSymbole(table, "if", MOTCLES);
-    ajoutSymbole(table, "else", MOTCLES);
-    ajoutSymbole(table, "then", MOTCLES);
-    ajoutSymbole(table, "while", MOTCLES);
-    ajoutSymbole(table, "do", MOTCLES);
-    ajoutSymbole(table, "return", MOTCLES);
-    ajoutSymbole(table, "fontion", MOTCLES);
-    ajoutSymbole(table, "var", MOTCLES);
-    ajoutSymbole(table, "const", MOTCLES);
-    ajoutSymbole(table, "mod", MOTCLES);
+// free d'une zone de la TS, qui peut être projetée depuis un instantané
+void libererZone(TS *table, int zone, void *donnees)
+{
+    if (table->projections[zone] != NULL)
+    {
+        munmap(table->projections[zone], table->taillesProjections[zone]);
+        table->projections[zone] = NULL;
+    }
+    else
+    {
+        free(donnees);
+    }
 }
 
-int chercherSymbole(TS *table, const char *lexeme)
+// realloc d'une zone de la TS : une zone projetée qui déborde de sa réservation
+// est recopiée une fois dans le tas
+void *reallouerZone(TS *table, int zone, void *donnees, size_t utile, size_t taille)
 {
-    int cle = hashFonction(lexeme);
-    int originaleCle = cle;
+    if (table->projections[zone] == NULL)
+        return realloc(donnees, taille);
+    void *copie = malloc(taille);
+    memcpy(copie, donnees, utile);
+    libererZone(table, zone, donnees);
+    return copie;
+}
 
-    while (1)
+// Double le nombre de cases et réinsère les identifiants (les entrées et l'arène
+// ne bougent pas : les identifiants de symboles restent valides)
+void agrandirIndex(TS *table)
+{
+    uint32_t nbCases = table->cases != NULL ? (table->masque + 1) * 2 : TAILLE_TS_INITIALE;
+    COMPTER(if (table->cases != NULL) compteurs.agrandissements++);
+    libererZone(table, ZONE_CASES, table->cases);
+    table->cases = malloc(nbCases * sizeof(CaseTS));
+    table->masque = nbCases - 1;
+    for (uint32_t i = 0; i < nbCases; i++)
+    {
+        table->cases[i].id = -1;
+    }
+    for (int id = 0; id < table->size; id++)
     {
-        if (strcmp(table->entries[cle].lexeme, "") != 0)
+        uint64_t h = table->entries[id].hash;
+        uint32_t cle = (uint32_t)h & table->masque;
+        while (table->cases[cle].id != -1)
         {
-            if (strcmp(table->entries[cle].lexeme, lexeme) == 0)
-            {
-                return cle;
-            }
+            cle = (cle + 1) & table->masque;
         }
+        table->cases[cle].empreinte = (uint32_t)(h >> 32);
+        table->cases[cle].id = id;
+    }
+}
+
+void initialiserTS(TS *table)
+{
+    memset(table, 0, sizeof(TS));
+    agrandirIndex(table);
+}
+
+void libererTS(TS *table)
+{
+    libererZone(table, ZONE_ENTREES, table->entries);
+    libererZone(table, ZONE_CASES, table->cases);
+    libererZone(table, ZONE_ARENE, table->arene);
+    memset(table, 0, sizeof(TS));
+}
+
+// Texte d'un symbole, terminé par '\0' dans l'arène
+const char *lexemeSymbole(const TS *table, int id)
+{
+    return table->arene + table->entries[id].offset;
+}
 
-        cle = (cle + 1) % MAX_SYMBOL_TABLE_SIZE;
+// Case de la table qui contient le lexème, ou première case vide de sa séquence
+// de sondage. Le taux de remplissage reste sous 3/4 : un échec s'arrête vite.
+uint32_t sonderTS(const TS *table, const char *lexeme, int longueur, uint64_t h)
+{
+    uint32_t empreinte = (uint32_t)(h >> 32);
+    uint32_t cle = (uint32_t)h & table->masque;
 
-        if (cle == originaleCle)
+    while (table->cases[cle].id != -1)
+    {
+        if (table->cases[cle].empreinte == empreinte)
         {
-            break;
+            const SymbolEntry *entree = &table->entries[table->cases[cle].id];
+            if (entree->longueur == (uint32_t)longueur &&
+                memcmp(table->arene + entree->offset, lexeme, longueur) == 0)
+            {
+                return cle;
+            }
         }
+        cle = (cle + 1) & table->masque;
     }
+    return cle;
+}
 
-    return -1;
+#ifdef COMPTEURS
+void noterRemplissage(const TS *table)
+{
+    double remplissage = (double)table->size / (table->masque + 1);
+    if (remplissage > compteurs.remplissageMax)
+        compteurs.remplissageMax = remplissage;
+    compteurs.symboles = table->size;
+    compteurs.cases = table->masque + 1;
+}
+
+// Nombre de cases visitées pour arriver à cle depuis la case de départ du hash
+void compterSondage(uint64_t *histogramme, const TS *table, uint64_t h, uint32_t cle)
+{
+    uint32_t longueur = ((cle - (uint32_t)h) & table->masque) + 1;
+    histogramme[longueur < MAX_SONDAGE ? longueur : MAX_SONDAGE]++;
+}
+#endif
+
+int chercherSymbole(TS *table, const char *lexeme, int longueur)
+{
+    uint64_t h = hashFonction(lexeme, longueur);
+    uint32_t cle = sonderTS(table, lexeme, longueur, h);
+    COMPTER(compterSondage(compteurs.sondagesRecherche, table, h, cle));
+    return table->cases[cle].id;
 }
 
-int ajoutSymbole(TS *table, const char *lexeme, LexemeType type)
+int ajoutSymbole(TS *table, const char *lexeme, int longueur, LexemeType type)
 {
-    int index = chercherSymbole(table, lexeme);
-    if (index != -1)
+    uint64_t h = hashFonction(lexeme, longueur);
+    uint32_t cle = sonderTS(table, lexeme, longueur, h);
+    COMPTER(compterSondage(compteurs.sondagesAjout, table, h, cle));
+    if (table->cases[cle].id != -1)
     {
-        return index;
+        return table->cases[cle].id;
     }
 
-    int cle = hashFonction((char *)lexeme);
-    int cleOriginale = cle;
-
-    while (strcmp(table->entries[cle].lexeme, "") != 0)
+    if ((uint64_t)(table->size + 1) * 4 > (uint64_t)(table->masque + 1) * 3)
+    {
+        agrandirIndex(table);
+        cle = sonderTS(table, lexeme, longueur, h);
+    }
+    if (table->size == table->capaciteEntrees)
+    {
+        table->capaciteEntrees = table->capaciteEntrees ? table->capaciteEntrees * 2 : TAILLE_TS_INITIALE;
+        table->entries = reallouerZone(table, ZONE_ENTREES, table->entries, table->size * sizeof(SymbolEntry),
+                                       table->capaciteEntrees * sizeof(SymbolEntry));
+    }
+    if (table->tailleArene + longueur + 1 > table->capaciteArene)
     {
-        cle = (cle + 1) % MAX_SYMBOL_TABLE_SIZE;
-        if (cle == cleOriginale)
+        while (table->tailleArene + longueur + 1 > table->capaciteArene)
         {
-            printf("Erreur: Table des symboles pleine\n");
-            return -1;
+            table->capaciteArene = table->capaciteArene ? table->capaciteArene * 2 : 1024;
         }
+        table->arene = reallouerZone(table, ZONE_ARENE, table->arene, table->tailleArene, table->capaciteArene);
     }
 
-    strncpy(table->entries[cle].lexeme, lexeme, MAX_LEXEME_LENGTH - 1);
-    table->entries[cle].lexeme[MAX_LEXEME_LENGTH - 1] = '\0';
-    table->entries[cle].type = type;
-    table->size++;
+    int id = table->size++;
+    SymbolEntry *entree = &table->entries[id];
+    entree->hash = h;
+    entree->offset = table->tailleArene;
+    entree->longueur = (uint32_t)longueur;
+    entree->type = (uint8_t)type;
+    entree->valeur = 0;
+    entree->debordement = type == NOMBRE && !convertirNombre(lexeme, longueur, &entree->valeur);
+    memcpy(table->arene + table->tailleArene, lexeme, longueur);
+    table->arene[table->tailleArene + longueur] = '\0';
+    table->tailleArene += longueur + 1;
 
-    return cle;
+    table->cases[cle].empreinte = (uint32_t)(h >> 32);
+    table->cases[cle].id = id;
+    COMPTER(noterRemplissage(table));
+    return id;
 }
 
 void afficherTS(TS *table)
 {
     printf("\n--- TABLE DES SYMBOLES ---\n");
-    for (int i = 0; i < MAX_SYMBOL_TABLE_SIZE; i++)
+    for (int i = 0; i < table->size; i++)
     {
-        if (table->entries[i].lexeme[0] != '\0')
-        {
-            if (table->entries[i].type == MOTCLES)
-                printf("%s mot cle\n", table->entries[i].lexeme);
-            else if (table->entries[i].type == IDENTIFIER)
-                printf("%s identificateur\n", table->entries[i].lexeme);
-            else if (table->entries[i].type == NOMBRE)
-                printf("%s num(%s)\n", table->entries[i].lexeme, table->entries[i].lexeme);
-        }
+        const char *lexeme = lexemeSymbole(table, i);
+        if (table->entries[i].type == IDENTIFIER)
+            printf("%s identificateur\n", lexeme);
+        else if (table->entries[i].type == NOMBRE && table->entries[i].debordement)
+            printf("%s num(trop grand)\n", lexeme);
+        else if (table->entries[i].type == NOMBRE)
+            printf("%s num(%" PRId64 ")\n", lexeme, table->entries[i].valeur);
     }
     printf("---------------------------\n");
 }
 
-void initialiserMatrcie(CSRmatrice *matrice)
+// --- INSTANTANE DE LA TS ---
+// Fichier : en-tête puis entrées, cases de l'index et arène, chacune alignée sur
+// ALIGNEMENT_INSTANTANE pour être projetée directement. Au chargement chaque zone
+// est projetée en copie privée (MAP_PRIVATE) au début d'une réservation : les
+// symboles ajoutés ensuite s'écrivent dans les pages copiées du processus, les
+// autres pages restent partagées entre les compilations via le cache de pages.
+#define VERSION_INSTANTANE 2
+#define ALIGNEMENT_INSTANTANE 65536 // plus grande taille de page courante
+#define TEMOIN_INSTANTANE "instantane"
+
+static const char magieInstantane[8] = {'M', 'C', 'T', 'S', '\r', '\n', '\032', '\n'};
+
+typedef struct
 {
-    memset(matrice, 0, sizeof(CSRmatrice));
+    char magie[8];
+    uint32_t version;
+    uint32_t tailleEntree; // sizeof(SymbolEntry)
+    uint32_t tailleCase;   // sizeof(CaseTS)
+    uint32_t nbSymboles;
+    uint32_t nbCases;
+    uint32_t reserve;
+    // hashFonction(TEMOIN_INSTANTANE) : l'index n'est valable qu'avec le même
+    // hachage et le même ordre des octets
+    uint64_t temoinHash;
+    uint64_t tailleArene;
+    uint64_t positions[NB_ZONES_TS];
+    uint64_t somme; // somme de contrôle de l'en-tête (somme à 0) et des zones
+} EnteteInstantane;
 
-    // 0=initial, 1=identifier, 2=OPERATEUR, 3=NOMBRE, 4=eq_op, 5=lt_op, 6=gt_op
-    // 7=div_op, 8=comment_start, 9=comment_body, 10=comment_star, 11=délimiteur
-    int idx = 0;
-    // État 0 (initial) - transitions sortantes
-    matrice->row_ptr[0] = 0;
-    // Transitions pour les espaces (État 0 -> État 0)
-    char whitespace[] = " \t\n\r";
-    for (int i = 0; whitespace[i] != '\0'; i++)
+// Somme de contrôle sur 4 voies indépendantes (8 octets chacune par tour)
+uint64_t sommeControle(uint64_t somme, const void *donnees, size_t taille)
+{
+    const uint64_t m = 0x9E3779B97F4A7C15ull;
+    const unsigned char *octets = donnees;
+    uint64_t voies[4] = {somme, somme ^ 1, somme ^ 2, somme ^ 3};
+    size_t i = 0;
+    for (; i + 32 <= taille; i += 32)
     {
-        matrice->col_ind[idx] = whitespace[i];
-        matrice->values[idx] = 0;
-        idx++;
+        for (int v = 0; v < 4; v++)
+        {
+            uint64_t mot;
+            memcpy(&mot, octets + i + 8 * v, 8);
+            voies[v] = (voies[v] ^ mot) * m;
+            voies[v] ^= voies[v] >> 29;
+        }
     }
-    // Transition pour la division/début de commentaire potentiel
-    matrice->col_ind[idx] = '/';
-    matrice->values[idx] = 7; // État pour '/' (potentiel début de commentaire)
-    idx++;
-
-    // Transitions pour identificateurs (État 0 -> État 1)
-    for (char c = 'a'; c <= 'z'; c++)
+    uint64_t reste[4] = {0, 0, 0, 0};
+    memcpy(reste, octets + i, taille - i);
+    uint64_t h = taille * m;
+    for (int v = 0; v < 4; v++)
     {
-        matrice->col_ind[idx] = c;
-        matrice->values[idx] = 1;
-        idx++;
+        h = (h ^ voies[v] ^ reste[v]) * m;
+        h ^= h >> 32;
     }
+    return h;
+}
 
-    for (char c = 'A'; c <= 'Z'; c++)
+size_t tailleZone(const EnteteInstantane *entete, int zone)
+{
+    switch (zone)
     {
-        matrice->col_ind[idx] = c;
-        matrice->values[idx] = 1;
-        idx++;
+    case ZONE_ENTREES:
+        return (size_t)entete->nbSymboles * sizeof(SymbolEntry);
+    case ZONE_CASES:
+        return (size_t)entete->nbCases * sizeof(CaseTS);
+    default:
+        return entete->tailleArene;
     }
+}
+
+uint64_t sommeInstantane(EnteteInstantane entete, const void *const zones[NB_ZONES_TS])
+{
+    entete.somme = 0;
+    uint64_t somme = sommeControle(0, &entete, sizeof(entete));
+    for (int z = 0; z < NB_ZONES_TS; z++)
+        somme = sommeControle(somme, zones[z], tailleZone(&entete, z));
+    return somme;
+}
 
-    // Transitions pour opérateurs (État 0 -> États spécifiques aux opérateurs)
-    // Opérateurs simples (restent dans l'état 2)
-    char simple_OPERATEURs[] = "+-*"; // '/' est maintenant traité séparément
-    for (int i = 0; simple_OPERATEURs[i] != '\0'; i++)
+// Écrit la table dans un fichier temporaire renommé à la fin : une compilation
+// qui projette l'ancien instantané n'en voit jamais une version partielle
+bool sauvegarderTS(const TS *table, const char *chemin)
+{
+    EnteteInstantane entete;
+    memset(&entete, 0, sizeof(entete));
+    memcpy(entete.magie, magieInstantane, sizeof(entete.magie));
+    entete.version = VERSION_INSTANTANE;
+    entete.tailleEntree = sizeof(SymbolEntry);
+    entete.tailleCase = sizeof(CaseTS);
+    entete.nbSymboles = (uint32_t)table->size;
+    entete.nbCases = table->masque + 1;
+    entete.temoinHash = hashFonction(TEMOIN_INSTANTANE, strlen(TEMOIN_INSTANTANE));
+    entete.tailleArene = table->tailleArene;
+    const void *zones[NB_ZONES_TS] = {table->entries, table->cases, table->arene};
+    uint64_t position = sizeof(entete);
+    for (int z = 0; z < NB_ZONES_TS; z++)
     {
-        matrice->col_ind[idx] = simple_OPERATEURs[i];
-        matrice->values[idx] = 2;
-        idx++;
+        position = (position + ALIGNEMENT_INSTANTANE - 1) / ALIGNEMENT_INSTANTANE * ALIGNEMENT_INSTANTANE;
+        entete.positions[z] = position;
+        position += tailleZone(&entete, z);
     }
+    entete.somme = sommeInstantane(entete, zones);
 
-    // Délimiteurs
-    char delimiteurs[] = ";,(){}";
-    for (int i = 0; delimiteurs[i] != '\0'; i++)
+    size_t longueur = strlen(chemin);
+    char *temporaire = malloc(longueur + 5);
+    memcpy(temporaire, chemin, longueur);
+    memcpy(temporaire + longueur, ".tmp", 5);
+    FILE *f = fopen(temporaire, "wb");
+    if (f == NULL)
     {
-        matrice->col_ind[idx] = delimiteurs[i];
-        matrice->values[idx] = 11;
-        idx++;
+        printf("Erreur: Impossible de creer '%s'\n", temporaire);
+        free(temporaire);
+        return false;
     }
-
-    // Opérateurs spéciaux qui peuvent devenir des opérateurs composés
-    matrice->col_ind[idx] = '=';
-    matrice->values[idx] = 4;
-    idx++;
-
-    matrice->col_ind[idx] = '<';
-    matrice->values[idx] = 5;
-    idx++;
-
-    matrice->col_ind[idx] = '>';
-    matrice->values[idx] = 6;
-    idx++;
-
-    // Transitions pour NOMBREs (État 0 -> État 3)
-    for (char c = '0'; c <= '9'; c++)
+    bool ok = fwrite(&entete, sizeof(entete), 1, f) == 1;
+    for (int z = 0; z < NB_ZONES_TS && ok; z++)
+    {
+        ok = fseek(f, (long)entete.positions[z], SEEK_SET) == 0 &&
+             fwrite(zones[z], 1, tailleZone(&entete, z), f) == tailleZone(&entete, z);
+    }
+    ok &= fclose(f) == 0;
+    if (!ok || rename(temporaire, chemin) != 0)
     {
-        matrice->col_ind[idx] = c;
-        matrice->values[idx] = 3;
-        idx++;
+        printf("Erreur: Ecriture de l'instantane '%s' impossible\n", chemin);
+        unlink(temporaire);
+        free(temporaire);
+        return false;
     }
+    free(temporaire);
+    return true;
+}
 
-    matrice->row_ptr[1] = idx;
+// Réserve `reserve` octets et projette au début, en copie privée, la zone
+// [position, position + taille) du fichier ; le reste de la réservation est
+// anonyme et ne coûte rien tant qu'il n'est pas écrit
+void *projeterZone(int fd, uint64_t position, size_t taille, size_t reserve)
+{
+    void *zone = mmap(NULL, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (zone == MAP_FAILED)
+        return NULL;
+    if (taille > 0 &&
+        mmap(zone, taille, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, (off_t)position) == MAP_FAILED)
+    {
+        munmap(zone, reserve);
+        return NULL;
+    }
+    return zone;
+}
 
-    // État 1 (identificateur) - transitions sortantes
-    // Identificateur peut accepter lettres, chiffres, underscore
-    for (char c = 'a'; c <= 'z'; c++)
+// Charge un instantané écrit par sauvegarderTS : l'en-tête est validé (version,
+// format, hachage, bornes des zones) et la somme de contrôle vérifiée avant toute
+// recherche. Les entrées et l'arène gardent autant de place libre que de données.
+bool chargerTS(TS *table, const char *chemin)
+{
+    memset(table, 0, sizeof(TS));
+    int fd = open(chemin, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("Erreur: Impossible d'ouvrir '%s'\n", chemin);
+        return false;
+    }
+    struct stat info;
+    EnteteInstantane entete;
+    if (fstat(fd, &info) != 0 || pread(fd, &entete, sizeof(entete), 0) != (ssize_t)sizeof(entete))
     {
-        matrice->col_ind[idx] = c;
-        matrice->values[idx] = 1;
-        idx++;
+        printf("Erreur: '%s' n'est pas un instantane de TS\n", chemin);
+        close(fd);
+        return false;
     }
 
-    for (char c = 'A'; c <= 'Z'; c++)
+    const char *erreur = NULL;
+    if (memcmp(entete.magie, magieInstantane, sizeof(entete.magie)) != 0)
+        erreur = "n'est pas un instantane de TS";
+    else if (entete.version != VERSION_INSTANTANE)
+        erreur = "a ete ecrit par une autre version";
+    else if (entete.tailleEntree != sizeof(SymbolEntry) || entete.tailleCase != sizeof(CaseTS) ||
+             entete.temoinHash != hashFonction(TEMOIN_INSTANTANE, strlen(TEMOIN_INSTANTANE)))
+        erreur = "a ete ecrit avec un autre format ou hachage";
+    else if (entete.nbCases < TAILLE_TS_INITIALE || (entete.nbCases & (entete.nbCases - 1)) != 0 ||
+             entete.nbSymboles > INT32_MAX || (uint64_t)entete.nbSymboles * 4 > (uint64_t)entete.nbCases * 3)
+        erreur = "a un index invalide";
+    for (int z = 0; z < NB_ZONES_TS && erreur == NULL; z++)
+    {
+        if (entete.positions[z] % ALIGNEMENT_INSTANTANE != 0 || entete.positions[z] > (uint64_t)info.st_size ||
+            tailleZone(&entete, z) > (uint64_t)info.st_size - entete.positions[z])
+            erreur = "est tronque";
+    }
+    if (erreur != NULL)
     {
-        matrice->col_ind[idx] = c;
-        matrice->values[idx] = 1;
-        idx++;
+        printf("Erreur: '%s' %s\n", chemin, erreur);
+        close(fd);
+        return false;
     }
 
-    for (char c = '0'; c <= '9'; c++)
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    void *zones[NB_ZONES_TS];
+    bool projete = true;
+    for (int z = 0; z < NB_ZONES_TS; z++)
+    {
+        size_t taille = tailleZone(&entete, z);
+        size_t reserve = z == ZONE_CASES ? taille : 2 * taille;
+        reserve = (reserve / page + 1) * page;
+        zones[z] = projeterZone(fd, entete.positions[z], taille, reserve);
+        table->projections[z] = zones[z];
+        table->taillesProjections[z] = reserve;
+        projete &= zones[z] != NULL;
+    }
+    close(fd);
+    if (!projete || sommeInstantane(entete, (const void *const *)zones) != entete.somme)
     {
-        matrice->col_ind[idx] = c;
-        matrice->values[idx] = 1;
-        idx++;
+        printf("Erreur: '%s' %s\n", chemin, projete ? "est corrompu (somme de controle)" : "ne peut pas etre projete");
+        libererTS(table);
+        return false;
     }
 
-    matrice->row_ptr[2] = idx;
+    table->entries = zones[ZONE_ENTREES];
+    table->size = (int)entete.nbSymboles;
+    size_t capacite = table->taillesProjections[ZONE_ENTREES] / sizeof(SymbolEntry);
+    table->capaciteEntrees = capacite < INT32_MAX ? (int)capacite : INT32_MAX;
+    table->cases = zones[ZONE_CASES];
+    table->masque = entete.nbCases - 1;
+    table->arene = zones[ZONE_ARENE];
+    table->tailleArene = entete.tailleArene;
+    table->capaciteArene = table->taillesProjections[ZONE_ARENE];
+    return true;
+}
+
+// Mots clés : hachage parfait sur (premier octet, dernier octet, longueur), sans
+// collision pour les 10 mots clés. Les cases sont calculées par le compilateur ;
+// une collision ajoutée par erreur réécrirait une case déjà initialisée, ce que
+// -Woverride-init transforme ici en erreur de compilation, quelles que soient les
+// options de la ligne de commande.
+#define NB_CASES_MOTS_CLES 16
+#define HASH_MOT_CLE(premier, dernier, longueur) \
+    ((2 * (unsigned)(premier) + 6 * (unsigned)(dernier) + (unsigned)(longueur)) & (NB_CASES_MOTS_CLES - 1))
+#define MOT_CLE(texte, premier, dernier, terminal) \
+    [HASH_MOT_CLE(premier, dernier, sizeof(texte) - 1)] = {texte, sizeof(texte) - 1, terminal}
+
+typedef struct
+{
+    const char *texte;
+    int longueur; // 0 : case vide
+    Terminal terminal;
+} MotCle;
 
-    // État 2 (opérateur simple) - pas de transitions sortantes
-    matrice->row_ptr[3] = idx;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Woverride-init"
+static const MotCle motsCles[NB_CASES_MOTS_CLES] = {
+    MOT_CLE("if", 'i', 'f', TERM_ERREUR),
+    MOT_CLE("else", 'e', 'e', TERM_ERREUR),
+    MOT_CLE("then", 't', 'n', TERM_ERREUR),
+    MOT_CLE("while", 'w', 'e', TERM_ERREUR),
+    MOT_CLE("do", 'd', 'o', TERM_ERREUR),
+    MOT_CLE("return", 'r', 'n', TERM_ERREUR),
+    MOT_CLE("fontion", 'f', 'n', TERM_ERREUR),
+    MOT_CLE("var", 'v', 'r', TERM_ERREUR),
+    MOT_CLE("const", 'c', 't', TERM_ERREUR),
+    MOT_CLE("mod", 'm', 'd', TERM_MOD),
+};
+#pragma GCC diagnostic pop
 
-    // État 3 (NOMBRE) - transitions sortantes
-    // NOMBRE peut accepter d'autres chiffres
-    for (char c = '0'; c <= '9'; c++)
+// Case du mot clé égal au lexème, -1 si ce n'est pas un mot clé
+int chercherMotCle(const char *lexeme, int64_t longueur)
+{
+    if (longueur < 2 || longueur > 7)
+    {
+        return -1;
+    }
+    unsigned cle = HASH_MOT_CLE((unsigned char)lexeme[0], (unsigned char)lexeme[longueur - 1], longueur);
+    if (motsCles[cle].longueur == longueur && memcmp(motsCles[cle].texte, lexeme, longueur) == 0)
     {
-        matrice->col_ind[idx] = c;
-        matrice->values[idx] = 3;
-        idx++;
+        return (int)cle;
     }
+    return -1;
+}
+
+void initialiserMatrcie(CSRmatrice *matrice)
+{
+    memset(matrice, 0, sizeof(CSRmatrice));
+    matrice->row_ptr = lignesAutomate;
+    matrice->col_ind = colonnesAutomate;
+    matrice->values = ciblesAutomate;
+}
 
-    matrice->row_ptr[4] = idx;
+int chercherEtatSuivant(CSRmatrice *matrice, int state, char input)
+{
+    if (matrice->modeDense)
+    {
+        int suivant = matrice->dense.suivant[state][matrice->dense.classe[(unsigned char)input]];
+        COMPTER(if (suivant != -1) compteurs.transitions[state]++; else compteurs.echecs[state]++);
+        return suivant;
+    }
 
-    // État 4 (opérateur =) - transition possible vers '=='
-    matrice->col_ind[idx] = '=';
-    matrice->values[idx] = 13;
-    idx++;
-    matrice->row_ptr[5] = idx;
+    int start = matrice->row_ptr[state];
+    int end = matrice->row_ptr[state + 1];
 
-    // État 5 (opérateur <) - transition possible vers '<='
-    matrice->col_ind[idx] = '=';
-    matrice->values[idx] = 13;
-    idx++;
-    matrice->row_ptr[6] = idx;
+    for (int i = start; i < end; i++)
+    {
+        if (matrice->col_ind[i] == (unsigned char)input)
+        {
+            COMPTER(compteurs.transitions[state]++; compteurs.rangCSR[state] += i - start);
+            return matrice->values[i];
+        }
+    }
 
-    // État 6 (opérateur >) - transition possible vers '>='
-    matrice->col_ind[idx] = '=';
-    matrice->values[idx] = 13;
-    idx++;
-    matrice->row_ptr[7] = idx;
+    COMPTER(compteurs.echecs[state]++);
+    return -1;
+}
 
-    // État 7 (opérateur /) - transitions
-    // Si suivi de '*', début de commentaire
-    matrice->col_ind[idx] = '*';
-    matrice->values[idx] = 8;
-    idx++;
+// Construit la table dense à partir de la matrice CSR et active le mode compilé
+void compilerMatrice(CSRmatrice *matrice)
+{
+    TableDense *dense = &matrice->dense;
+    signed char colonnes[MAX_CLASSES][MAX_STATES];
+    signed char colonne[MAX_STATES];
 
-    // Pour tous les autres caractères, c'est juste un opérateur de division (ne consomme pas le caractère suivant)
-    // => Pas de transition, on reste dans l'état opérateur
-    matrice->row_ptr[8] = idx;
+    matrice->modeDense = false;
+    dense->nbClasses = 0;
+#ifdef COMPTEURS
+    // Les recherches faites ici pour construire la table ne sont pas des transitions du lexeur
+    Compteurs avant = compteurs;
+#endif
 
-    // État 8 (début de commentaire, après '/*') - transitions
-    // Tout caractère sauf '*' reste dans le corps du commentaire
-    for (int i = 0; i < 128; i++)
+    for (int octet = 0; octet < NB_OCTETS; octet++)
     {
-        if (i != '*')
-        {
-            matrice->col_ind[idx] = i;
-            matrice->values[idx] = 9;
-            idx++;
-        }
-        else
+        // Colonne de l'octet : état suivant pour chaque état (parcours CSR d'origine)
+        for (int etat = 0; etat < MAX_STATES; etat++)
         {
-            matrice->col_ind[idx] = '*';
-            matrice->values[idx] = 10;
-            idx++;
+            colonne[etat] = (signed char)chercherEtatSuivant(matrice, etat, (char)octet);
         }
-    }
-    matrice->row_ptr[9] = idx;
 
-    // État 9 (corps du commentaire) - transitions
-    // Tout caractère sauf '*' reste dans le corps du commentaire
-    for (int i = 0; i < 128; i++)
-    {
-        if (i != '*')
+        int c = 0;
+        while (c < dense->nbClasses && memcmp(colonnes[c], colonne, MAX_STATES) != 0)
         {
-            matrice->col_ind[idx] = i;
-            matrice->values[idx] = 9;
-            idx++;
+            c++;
         }
-        else
+        if (c == dense->nbClasses)
         {
-            matrice->col_ind[idx] = '*';
-            matrice->values[idx] = 10;
-            idx++;
+            if (dense->nbClasses == MAX_CLASSES)
+            {
+                printf("Erreur: Trop de classes de caracteres, mode CSR conserve\n");
+                COMPTER(compteurs = avant);
+                return;
+            }
+            memcpy(colonnes[c], colonne, MAX_STATES);
+            dense->nbClasses++;
         }
+        dense->classe[octet] = (unsigned char)c;
     }
-    matrice->row_ptr[10] = idx;
+    COMPTER(compteurs = avant);
 
-    // État 10 (potentielle fin de commentaire, après '*') - transitions
-    // Si suivi de '/', fin de commentaire
-    matrice->col_ind[idx] = '/';
-    matrice->values[idx] = 0;
-    idx++;
-    // Si suivi de '*', reste dans l'état potentiel fin de commentaire
-    matrice->col_ind[idx] = '*';
-    matrice->values[idx] = 10;
-    idx++;
-    // Tout autre caractère retourne au corps du commentaire
-    for (int i = 0; i < 128; i++)
+    for (int etat = 0; etat < MAX_STATES; etat++)
     {
-        if (i != '*' && i != '/')
+        for (int c = 0; c < MAX_CLASSES; c++)
         {
-            matrice->col_ind[idx] = i;
-            matrice->values[idx] = 9;
-            idx++;
+            dense->suivant[etat][c] = c < dense->nbClasses ? colonnes[c][etat] : -1;
         }
     }
 
-    matrice->row_ptr[11] = idx;
-    matrice->row_ptr[12] = idx;
-    matrice->row_ptr[13] = idx;
+    matrice->modeDense = true;
 }
 
-int chercherEtatSuivant(CSRmatrice *matrice, int state, char input)
+LexemeType getFinaleStatType(int state)
 {
-    int start = matrice->row_ptr[state];
-    int end = matrice->row_ptr[state + 1];
+    return typeEtatAutomate[state];
+}
 
-    for (int i = start; i < end; i++)
+bool estCommentaire(int state)
+{
+    return (ETATS_IGNORES >> state) & 1;
+}
+
+// Sauts rapides pour l'état initial (blancs) et le corps de commentaire.
+// Les versions vectorielles lisent des blocs non alignés entièrement compris entre
+// p et fin (position du '\0' final) ; le dernier bloc incomplet est parcouru octet
+// par octet, de sorte qu'aucune lecture ne sort du tampon de la source.
+#if defined(__AVX2__)
+#define TAILLE_BLOC 32
+typedef __m256i BlocOctets;
+#define chargerBloc(p) _mm256_loadu_si256((const __m256i *)(p))
+#define egalOctet(v, c) _mm256_cmpeq_epi8((v), _mm256_set1_epi8(c))
+#define ouBloc(a, b) _mm256_or_si256((a), (b))
+#define masqueBloc(v) ((uint32_t)_mm256_movemask_epi8(v))
+#elif defined(__SSE2__)
+#define TAILLE_BLOC 16
+typedef __m128i BlocOctets;
+#define chargerBloc(p) _mm_loadu_si128((const __m128i *)(p))
+#define egalOctet(v, c) _mm_cmpeq_epi8((v), _mm_set1_epi8(c))
+#define ouBloc(a, b) _mm_or_si128((a), (b))
+#define masqueBloc(v) ((uint32_t)_mm_movemask_epi8(v))
+#endif
+
+// Renvoie la position du premier octet qui n'est pas un blanc (' ', '\t', '\n', '\r')
+const char *sauterBlancs(const char *p, const char *fin)
+{
+#ifdef TAILLE_BLOC
+    while (fin - p >= TAILLE_BLOC)
     {
-        if (matrice->col_ind[i] == input)
+        BlocOctets v = chargerBloc(p);
+        BlocOctets blancs = ouBloc(ouBloc(egalOctet(v, ' '), egalOctet(v, '\t')),
+                                   ouBloc(egalOctet(v, '\n'), egalOctet(v, '\r')));
+        uint32_t arret = ~masqueBloc(blancs);
+#if TAILLE_BLOC == 16
+        arret &= 0xFFFF;
+#endif
+        if (arret != 0)
         {
-            return matrice->values[i];
+            return p + __builtin_ctz(arret);
         }
+        p += TAILLE_BLOC;
+    }
+#else
+    (void)fin;
+#endif
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+    {
+        p++;
     }
+    return p;
+}
 
-    return -1;
+// Renvoie la position du premier '*' ou du caractère nul (seuls octets qui font
+// sortir le corps de commentaire de sa boucle, UTF-8 compris)
+const char *chercherEtoile(const char *p, const char *fin)
+{
+#ifdef TAILLE_BLOC
+    while (fin - p >= TAILLE_BLOC)
+    {
+        BlocOctets v = chargerBloc(p);
+        uint32_t arret = masqueBloc(ouBloc(egalOctet(v, '*'), egalOctet(v, '\0')));
+        if (arret != 0)
+        {
+            return p + __builtin_ctz(arret);
+        }
+        p += TAILLE_BLOC;
+    }
+#else
+    (void)fin;
+#endif
+    while (*p != '*' && *p != '\0')
+    {
+        p++;
+    }
+    return p;
 }
 
-LexemeType getFinaleStatType(int state)
+// --- VALIDATION UTF-8 ---
+// L'entrée est validée avant le lexeur (fichier, chaîne) ou à chaque lecture (flux) :
+// l'automate peut alors accepter les octets non ASCII par classes (commentaires,
+// identificateurs selon jetons.def) sans vérifier les séquences lui-même.
+
+// Longueur de la séquence valide qui commence en p[i] (au plus fin), 0 si invalide
+int sequenceUTF8(const unsigned char *p, int64_t i, int64_t fin)
 {
-    if (state == 1)
-        return IDENTIFIER;
-    if (state == 2 || state == 7)
-        return OPERATEUR;
-    if (state == 5 || state == 6 || state == 13)
+    unsigned char c = p[i];
+    if (c < 0x80)
+        return 1;
+    int longueur;
+    unsigned char min = 0x80, max = 0xBF; // bornes du deuxième octet
+    if (c >= 0xC2 && c <= 0xDF)
     {
-        return COMPARATEUR;
+        longueur = 2;
     }
-    if (state == 4)
+    else if (c >= 0xE0 && c <= 0xEF)
     {
-        return AFECTATION;
+        longueur = 3;
+        min = c == 0xE0 ? 0xA0 : 0x80; // forme trop longue
+        max = c == 0xED ? 0x9F : 0xBF; // demi-codets UTF-16
     }
+    else if (c >= 0xF0 && c <= 0xF4)
+    {
+        longueur = 4;
+        min = c == 0xF0 ? 0x90 : 0x80;
+        max = c == 0xF4 ? 0x8F : 0xBF; // au-delà de U+10FFFF
+    }
+    else
+    {
+        return 0;
+    }
+    if (i + longueur > fin || p[i + 1] < min || p[i + 1] > max)
+        return 0;
+    for (int j = 2; j < longueur; j++)
+    {
+        if ((p[i + j] & 0xC0) != 0x80)
+            return 0;
+    }
+    return longueur;
+}
 
-    if (state == 3)
-        return NOMBRE;
-    if (state == 11)
+// Séquence par séquence, en sautant l'ASCII par blocs ; renvoie l'offset du
+// premier octet invalide dans [i, fin), -1 si tout est valide
+int64_t validerUTF8Sequentiel(const char *texte, int64_t i, int64_t fin)
+{
+    const unsigned char *p = (const unsigned char *)texte;
+    while (i < fin)
     {
-        return DELIMITEUR;
+#if defined(__SSE2__)
+        if (i + 16 <= fin)
+        {
+            uint32_t nonAscii = (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(p + i)));
+            if (nonAscii == 0)
+            {
+                i += 16;
+                continue;
+            }
+            i += __builtin_ctz(nonAscii);
+        }
+#endif
+        // Séquences consécutives sans repasser par le saut d'ASCII
+        do
+        {
+            int longueur = sequenceUTF8(p, i, fin);
+            if (longueur == 0)
+                return i;
+            i += longueur;
+        } while (i < fin && p[i] >= 0x80);
     }
+    return -1;
+}
 
-    return UNKNOWN;
+#if defined(__AVX2__)
+// Algorithme de Keiser et Lemire : chaque octet est classé d'après les 4 bits de
+// poids fort et de poids faible de l'octet précédent et les 4 bits de poids fort
+// du sien (trois tables de 16 entrées, pshufb) ; le ET des trois est non nul pour
+// une paire d'octets invalide. Les troisième et quatrième octets des séquences
+// longues sont vérifiés à part (suite23).
+#define TROP_COURT (1 << 0)
+#define TROP_LONG (1 << 1)
+#define SURLONG_3 (1 << 2)
+#define TROP_GRAND (1 << 3)
+#define SUBSTITUT (1 << 4)
+#define SURLONG_2 (1 << 5)
+#define TROP_GRAND_1000 (1 << 6)
+#define SURLONG_4 (1 << 6)
+#define DEUX_SUITES (1 << 7)
+#define RETENUE (TROP_COURT | TROP_LONG | DEUX_SUITES)
+
+// Les n derniers octets de avant suivis des 32 - n premiers de bloc
+#define PRECEDENT(bloc, avant, n) \
+    _mm256_alignr_epi8((bloc), _mm256_permute2x128_si256((avant), (bloc), 0x21), 16 - (n))
+#define TABLE16(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+
+static inline __m256i erreursUTF8(__m256i bloc, __m256i avant)
+{
+    const __m256i hautPrecedent =
+        TABLE16(TROP_LONG, TROP_LONG, TROP_LONG, TROP_LONG, TROP_LONG, TROP_LONG, TROP_LONG, TROP_LONG, DEUX_SUITES,
+                DEUX_SUITES, DEUX_SUITES, DEUX_SUITES, TROP_COURT | SURLONG_2, TROP_COURT,
+                TROP_COURT | SURLONG_3 | SUBSTITUT, TROP_COURT | TROP_GRAND | TROP_GRAND_1000 | SURLONG_4);
+    const char plus = RETENUE | TROP_GRAND | TROP_GRAND_1000;
+    const __m256i basPrecedent =
+        TABLE16(RETENUE | SURLONG_3 | SURLONG_2 | SURLONG_4, RETENUE | SURLONG_2, RETENUE, RETENUE,
+                RETENUE | TROP_GRAND, plus, plus, plus, plus, plus, plus, plus, plus, plus | SUBSTITUT, plus, plus);
+    const __m256i hautCourant =
+        TABLE16(TROP_COURT, TROP_COURT, TROP_COURT, TROP_COURT, TROP_COURT, TROP_COURT, TROP_COURT, TROP_COURT,
+                (char)(TROP_LONG | SURLONG_2 | DEUX_SUITES | SURLONG_3 | TROP_GRAND_1000 | SURLONG_4),
+                (char)(TROP_LONG | SURLONG_2 | DEUX_SUITES | SURLONG_3 | TROP_GRAND),
+                (char)(TROP_LONG | SURLONG_2 | DEUX_SUITES | SUBSTITUT | TROP_GRAND),
+                (char)(TROP_LONG | SURLONG_2 | DEUX_SUITES | SUBSTITUT | TROP_GRAND), TROP_COURT, TROP_COURT,
+                TROP_COURT, TROP_COURT);
+    const __m256i quartet = _mm256_set1_epi8(0x0F);
+
+    __m256i precedent1 = PRECEDENT(bloc, avant, 1);
+    __m256i cas = _mm256_and_si256(
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(hautPrecedent, _mm256_and_si256(_mm256_srli_epi16(precedent1, 4), quartet)),
+            _mm256_shuffle_epi8(basPrecedent, _mm256_and_si256(precedent1, quartet))),
+        _mm256_shuffle_epi8(hautCourant, _mm256_and_si256(_mm256_srli_epi16(bloc, 4), quartet)));
+    // Octets qui doivent être des suites : 2 après un 111xxxxx, 3 après un 1111xxxx
+    __m256i troisieme = _mm256_subs_epu8(PRECEDENT(bloc, avant, 2), _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    __m256i quatrieme = _mm256_subs_epu8(PRECEDENT(bloc, avant, 3), _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    __m256i suite23 = _mm256_and_si256(_mm256_or_si256(troisieme, quatrieme), _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(suite23, cas);
 }
 
-bool estCommentaire(int state)
+// Non nul si le bloc se termine au milieu d'une séquence
+static inline __m256i finIncomplete(__m256i bloc)
 {
-    return (state == 8 || state == 9 || state == 10);
+    const __m256i max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1),
+                                         (char)(0xE0 - 1), (char)(0xC0 - 1));
+    return _mm256_subs_epu8(bloc, max);
 }
+#endif
 
-LexemeType lexical_analyzer(CSRmatrice *matrice, const char *input, int *index, TS *table, char *lexeme_buffer)
+#if defined(__AVX2__)
+// Position exacte d'une erreur vue dans le bloc qui commence en i : reprise
+// séquentielle depuis le début de la séquence qui déborde du bloc précédent
+static int64_t reprendreUTF8(const char *texte, int64_t i, int64_t fin)
 {
-    int Q = 0;
-    bool trans = true;
-    int lexemeLength = 0;
-    bool exitingComment = false;
+    int64_t debut = i >= 3 ? i - 3 : 0;
+    while (debut < i && (texte[debut] & 0xC0) == 0x80)
+        debut++;
+    return validerUTF8Sequentiel(texte, debut, fin);
+}
+#endif
+
+// Nombre d'octets de la séquence commencée mais coupée par la fin de texte (0 à 3)
+int sequenceCoupee(const char *texte, int64_t longueur)
+{
+    const unsigned char *p = (const unsigned char *)texte;
+    for (int k = 1; k <= 3 && k <= longueur; k++)
+    {
+        unsigned char c = p[longueur - k];
+        if (c < 0x80)
+            return 0;
+        if (c >= 0xC0)
+        {
+            int attendus = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : 2;
+            return attendus > k ? k : 0;
+        }
+    }
+    return 0;
+}
+
+// Valide texte[0, longueur) ; renvoie l'offset du premier octet invalide, -1 si
+// tout est valide. Avec incomplet, une séquence coupée par la fin n'est pas une
+// erreur : *incomplet reçoit son nombre d'octets, qui ne sont pas vérifiés.
+int64_t validerUTF8(const char *texte, int64_t longueur, int *incomplet)
+{
+    int64_t fin = longueur;
+    if (incomplet != NULL)
+    {
+        *incomplet = sequenceCoupee(texte, longueur);
+        fin -= *incomplet;
+    }
+#if defined(__AVX2__)
+    __m256i avant = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    int64_t i = 0;
+    for (; i < fin; i += 32)
+    {
+        __m256i bloc;
+        if (i + 32 <= fin)
+        {
+            bloc = _mm256_loadu_si256((const __m256i *)(texte + i));
+        }
+        else
+        {
+            // Dernier bloc complété par des zéros (ASCII)
+            char reste[32] = {0};
+            memcpy(reste, texte + i, fin - i);
+            bloc = _mm256_loadu_si256((const __m256i *)reste);
+        }
+        __m256i erreur = incomplete;
+        if (_mm256_movemask_epi8(bloc) != 0)
+        {
+            erreur = erreursUTF8(bloc, avant);
+            incomplete = finIncomplete(bloc);
+        }
+        else
+        {
+            incomplete = _mm256_setzero_si256();
+        }
+        avant = bloc;
+        if (!_mm256_testz_si256(erreur, erreur))
+        {
+            return reprendreUTF8(texte, i, fin);
+        }
+    }
+    if (!_mm256_testz_si256(incomplete, incomplete))
+        return reprendreUTF8(texte, fin, fin);
+    return -1;
+#else
+    return validerUTF8Sequentiel(texte, 0, fin);
+#endif
+}
+
+// Source d'entrée du lexeur : chaîne en mémoire, fichier projeté (mmap) ou flux
+// (stdin, tube, texte d'un document en blocs) relu dans une fenêtre de taille
+// fixe. Les offsets sont absolus et sur 64 bits ; donnees[longueur] vaut toujours
+// '\0'.
+typedef struct
+{
+    const char *donnees; // octets disponibles
+    int64_t base;        // offset absolu de donnees[0]
+    int64_t longueur;    // nombre d'octets valides dans donnees
+    int fd;              // flux à relire, -1 si toute l'entrée est en mémoire
+    // Flux sans fd : copie au plus taille octets depuis l'offset absolu position
+    ssize_t (*lireSuite)(void *contexte, int64_t position, char *destination, size_t taille);
+    void *contexteLecture;
+    char *fenetre;       // tampon du mode flux
+    size_t capacite;     // taille de la fenêtre
+    int64_t ancre;       // début du lexème en cours, conservé lors d'un rechargement (-1 : aucun)
+    void *projection;    // zone mmap du mode fichier
+    size_t tailleProjection;
+    int64_t erreurUTF8;  // offset de la première séquence UTF-8 invalide, -1 sinon
+    unsigned char resteUTF8[4]; // mode flux : séquence coupée par la dernière lecture
+    int nbResteUTF8;
+    int64_t debutResteUTF8;
+} Source;
+
+void sourceDepuisChaine(Source *src, const char *texte)
+{
+    memset(src, 0, sizeof(Source));
+    src->donnees = texte;
+    src->longueur = strlen(texte);
+    src->fd = -1;
+    src->ancre = -1;
+    src->erreurUTF8 = validerUTF8(texte, src->longueur, NULL);
+}
+
+// Texte déjà en mémoire dont la longueur est connue (texte[longueur] vaut '\0')
+void sourceDepuisTampon(Source *src, const char *texte, int64_t longueur)
+{
+    memset(src, 0, sizeof(Source));
+    src->donnees = texte;
+    src->longueur = longueur;
+    src->fd = -1;
+    src->ancre = -1;
+    src->erreurUTF8 = validerUTF8(texte, longueur, NULL);
+}
+
+// Projette un fichier en lecture seule. Une page anonyme (remplie de zéros) est
+// réservée derrière le fichier pour garantir le '\0' final, même quand la taille
+// du fichier est un multiple de la taille de page.
+bool ouvrirFichier(Source *src, const char *chemin)
+{
+    memset(src, 0, sizeof(Source));
+    src->fd = -1;
+    src->ancre = -1;
+
+    int fd = open(chemin, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("Erreur: Impossible d'ouvrir '%s'\n", chemin);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        printf("Erreur: Impossible de lire la taille de '%s'\n", chemin);
+        close(fd);
+        return false;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t taille = (size_t)info.st_size;
+    src->tailleProjection = (taille / page + 1) * page;
+    src->projection = mmap(NULL, src->tailleProjection, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (src->projection == MAP_FAILED ||
+        (taille > 0 && mmap(src->projection, taille, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED))
+    {
+        printf("Erreur: Projection de '%s' impossible\n", chemin);
+        if (src->projection != MAP_FAILED)
+            munmap(src->projection, src->tailleProjection);
+        src->projection = NULL;
+        close(fd);
+        return false;
+    }
+    close(fd);
+    madvise(src->projection, src->tailleProjection, MADV_SEQUENTIAL);
+
+    src->donnees = src->projection;
+    src->longueur = (int64_t)taille;
+    src->erreurUTF8 = validerUTF8(src->donnees, src->longueur, NULL);
+    return true;
+}
+
+// Mode flux : la mémoire utilisée reste celle de la fenêtre, quelle que soit la
+// taille de l'entrée. Seul le lexème en cours (ancre) est conservé d'une fenêtre à
+// la suivante ; la fenêtre ne grandit que pour un lexème plus long qu'elle.
+void ouvrirFlux(Source *src, int fd, size_t capacite)
+{
+    memset(src, 0, sizeof(Source));
+    src->fd = fd;
+    src->ancre = -1;
+    src->capacite = capacite;
+    // Un octet de plus pour le '\0' final
+    src->fenetre = malloc(capacite + 1);
+    src->fenetre[0] = '\0';
+    src->donnees = src->fenetre;
+    src->erreurUTF8 = -1;
+}
+
+// Mode flux : valide les n octets lus à l'offset absolu position, en raccordant la
+// séquence coupée par la lecture précédente
+void validerLecture(Source *src, const char *octets, int64_t n, int64_t position)
+{
+    int64_t i = 0;
+    while (src->erreurUTF8 < 0 && src->nbResteUTF8 > 0 && i < n)
+    {
+        src->resteUTF8[src->nbResteUTF8++] = (unsigned char)octets[i++];
+        unsigned char tete = src->resteUTF8[0];
+        int attendus = tete >= 0xF0 ? 4 : tete >= 0xE0 ? 3 : 2;
+        if (src->nbResteUTF8 == attendus || (octets[i - 1] & 0xC0) != 0x80)
+        {
+            if (sequenceUTF8(src->resteUTF8, 0, src->nbResteUTF8) != src->nbResteUTF8)
+                src->erreurUTF8 = src->debutResteUTF8;
+            src->nbResteUTF8 = 0;
+        }
+    }
+    if (src->erreurUTF8 >= 0 || i == n)
+        return;
+    int coupe;
+    int64_t erreur = validerUTF8(octets + i, n - i, &coupe);
+    if (erreur >= 0)
+    {
+        src->erreurUTF8 = position + i + erreur;
+        return;
+    }
+    memcpy(src->resteUTF8, octets + n - coupe, coupe);
+    src->nbResteUTF8 = coupe;
+    src->debutResteUTF8 = position + n - coupe;
+}
+
+// Relit la fenêtre quand le lexeur atteint sa fin ; renvoie false en fin d'entrée
+bool rechargerSource(Source *src, int64_t index)
+{
+    if ((src->fd < 0 && src->lireSuite == NULL) || index != src->base + src->longueur)
+    {
+        return false;
+    }
+
+    int64_t garde = src->ancre >= 0 ? index - src->ancre : 0;
+    if (garde == (int64_t)src->capacite)
+    {
+        src->capacite *= 2;
+        src->fenetre = realloc(src->fenetre, src->capacite + 1);
+        src->donnees = src->fenetre;
+    }
+    memmove(src->fenetre, src->fenetre + (index - garde - src->base), garde);
+    src->base = index - garde;
+    src->longueur = garde;
+
+    while (src->longueur == garde)
+    {
+        ssize_t lus = src->lireSuite != NULL ? src->lireSuite(src->contexteLecture, src->base + garde,
+                                                              src->fenetre + garde, src->capacite - garde)
+                                             : read(src->fd, src->fenetre + garde, src->capacite - garde);
+        if (lus <= 0)
+        {
+            // Fin du flux (ou erreur de lecture) : plus rien à relire
+            src->fd = -1;
+            src->lireSuite = NULL;
+            src->fenetre[src->longueur] = '\0';
+            if (src->nbResteUTF8 > 0 && src->erreurUTF8 < 0)
+                src->erreurUTF8 = src->debutResteUTF8;
+            return false;
+        }
+        validerLecture(src, src->fenetre + src->longueur, lus, src->base + src->longueur);
+        src->longueur += lus;
+    }
+    src->fenetre[src->longueur] = '\0';
+    return true;
+}
+
+// Texte d'un lexème s'il est encore en mémoire (NULL sinon, en mode flux)
+const char *texteSource(const Source *src, int64_t debut, int64_t longueur)
+{
+    if (debut < src->base || debut + longueur > src->base + src->longueur)
+    {
+        return NULL;
+    }
+    return src->donnees + (debut - src->base);
+}
+
+void fermerSource(Source *src)
+{
+    if (src->projection != NULL)
+        munmap(src->projection, src->tailleProjection);
+    free(src->fenetre);
+    memset(src, 0, sizeof(Source));
+    src->fd = -1;
+}
+
+// Octet à l'offset absolu index ('\0' en fin d'entrée)
+char octetSource(Source *src, int64_t index)
+{
+    if (index - src->base == src->longueur)
+    {
+        rechargerSource(src, index);
+    }
+    return src->donnees[index - src->base];
+}
+
+// Analyse un lexème sans le copier : il occupe [*debut, *index) dans la source.
+// *symbole reçoit son indice dans la TS (identificateur, nombre) ou la case du mot
+// clé dans motsCles, -1 sinon. *terminal reçoit le terminal porté par l'état
+// d'acceptation (ou par le mot clé), TERM_ERREUR pour un lexème non reconnu.
+LexemeType lexical_analyzer(CSRmatrice *matrice, Source *src, int64_t *index, TS *table, int64_t *debut, int *symbole,
+                            Terminal *terminal)
+{
+    int Q = 0;
+    bool trans = true;
 
     // Position de sauvegarde pour implémenter la règle du plus long préfixe
-    int savedIndex = *index;
+    int64_t savedIndex = *index;
     int savedQ = Q;
-    int savedLexemeLength = 0;
+    *debut = *index;
+    *symbole = -1;
     // Implémentation du noyau de l'automate suivant l'algorithme fourni
-    char car = input[*index];
+    char car = octetSource(src, *index);
     while (trans)
     {
+        // Boucles de l'état initial et du corps de commentaire : avancer d'un bloc
+        // au lieu d'un octet (en mode flux, le saut se poursuit après chaque rechargement)
+        if (Q == ETAT_INITIAL)
+        {
+            do
+            {
+                const char *p = sauterBlancs(src->donnees + (*index - src->base), src->donnees + src->longueur);
+                COMPTER(compteurs.sautes[ETAT_INITIAL] += src->base + (p - src->donnees) - *index);
+                *index = src->base + (p - src->donnees);
+            } while (rechargerSource(src, *index));
+            // Le lexème commence à la sortie de l'état 0 (après blancs et commentaires)
+            savedIndex = *index;
+            *debut = *index;
+            src->ancre = *index;
+            car = octetSource(src, *index);
+        }
+        else if (Q == ETAT_CORPS_COMMENTAIRE)
+        {
+            do
+            {
+                const char *p = chercherEtoile(src->donnees + (*index - src->base), src->donnees + src->longueur);
+                COMPTER(compteurs.sautes[ETAT_CORPS_COMMENTAIRE] += src->base + (p - src->donnees) - *index);
+                *index = src->base + (p - src->donnees);
+            } while (rechargerSource(src, *index));
+            savedIndex = *index;
+            car = octetSource(src, *index);
+        }
+
         savedQ = Q;
         Q = chercherEtatSuivant(matrice, Q, car);
 
         if (Q != -1)
         {
-
-            exitingComment = (estCommentaire(savedQ) && Q == 0);
-
-            if (!(savedQ == 0 && Q == 0))
+            // Inutile de garder le texte d'un commentaire en mémoire
+            if (estCommentaire(Q))
             {
-                lexeme_buffer[lexemeLength++] = car;
+                src->ancre = -1;
             }
 
             (*index)++;
-            LexemeType currentType = getFinaleStatType(Q);
             savedIndex = *index;
             savedQ = Q;
-            savedLexemeLength = lexemeLength;
-
-            if (exitingComment)
-            {
-                lexemeLength = 0;
-                savedLexemeLength = 0;
-            }
-            car = input[*index];
+            car = octetSource(src, *index);
         }
         else
         {
@@ -735,141 +1637,5462 @@ LexemeType lexical_analyzer(CSRmatrice *matrice, const char *input, int *index,
     }
 
     *index = savedIndex;
-    lexeme_buffer[savedLexemeLength] = '\0';
+    src->ancre = -1;
+    int64_t longueur = *index - *debut;
+    // Le texte reste en mémoire jusqu'au prochain appel du lexeur
+    const char *lexeme = texteSource(src, *debut, longueur);
     LexemeType type = getFinaleStatType(savedQ);
+    *terminal = terminalEtatAutomate[savedQ];
     if (type != UNKNOWN)
     {
-        int symbolIndex = chercherSymbole(table, lexeme_buffer);
-        if (symbolIndex != -1 && table->entries[symbolIndex].type == MOTCLES)
+        // Seul un identificateur peut être un mot clé
+        if (type == IDENTIFIER && (*symbole = chercherMotCle(lexeme, longueur)) != -1)
         {
             type = MOTCLES;
+            *terminal = motsCles[*symbole].terminal;
         }
         else if (type == IDENTIFIER)
         {
-            ajoutSymbole(table, lexeme_buffer, IDENTIFIER);
+            *symbole = ajoutSymbole(table, lexeme, longueur, IDENTIFIER);
         }
         else if (type == NOMBRE)
         {
-            ajoutSymbole(table, lexeme_buffer, NOMBRE);
+            // Le littéral est converti à son premier ajout dans la TS (convertirNombre)
+            *symbole = ajoutSymbole(table, lexeme, longueur, NOMBRE);
         }
+    }
+
+    return type;
+}
+
+// Flot de jetons (structure de tableaux) produit par tokenize : le texte des
+// lexèmes n'est jamais copié, seuls leur position et leur longueur sont gardées
+typedef struct
+{
+    unsigned char *type;     // LexemeType
+    unsigned char *terminal; // Terminal correspondant dans la table d'analyse
+    int64_t *debut;          // offset absolu du lexème dans la source
+    uint32_t *longueur;
+    int32_t *symbole; // indice dans la TS (case de motsCles pour MOTCLES), -1 si aucun
+    size_t nb;
+    size_t capacite;
+} FlotJetons;
+
+void initialiserFlot(FlotJetons *flot)
+{
+    memset(flot, 0, sizeof(FlotJetons));
+}
+
+void libererFlot(FlotJetons *flot)
+{
+    free(flot->type);
+    free(flot->terminal);
+    free(flot->debut);
+    free(flot->longueur);
+    free(flot->symbole);
+    initialiserFlot(flot);
+}
 
-        return type;
+// Garantit la place pour nb jetons au total
+void reserverJetons(FlotJetons *flot, size_t nb)
+{
+    if (nb <= flot->capacite)
+    {
+        return;
     }
-    else if (savedLexemeLength > 0)
+    while (flot->capacite < nb)
     {
-        printf("Erreur : Lexeme non reconnu - '%s'\n", lexeme_buffer);
-        return UNKNOWN;
+        flot->capacite = flot->capacite ? flot->capacite * 2 : 1024;
     }
+    flot->type = realloc(flot->type, flot->capacite);
+    flot->terminal = realloc(flot->terminal, flot->capacite);
+    flot->debut = realloc(flot->debut, flot->capacite * sizeof(int64_t));
+    flot->longueur = realloc(flot->longueur, flot->capacite * sizeof(uint32_t));
+    flot->symbole = realloc(flot->symbole, flot->capacite * sizeof(int32_t));
+}
 
-    return UNKNOWN;
+void ajouterJeton(FlotJetons *flot, LexemeType type, Terminal terminal, int64_t debut, int64_t longueur, int symbole)
+{
+    reserverJetons(flot, flot->nb + 1);
+    size_t k = flot->nb++;
+    flot->type[k] = (unsigned char)type;
+    flot->terminal[k] = (unsigned char)terminal;
+    flot->debut[k] = debut;
+    flot->longueur[k] = longueur < UINT32_MAX ? (uint32_t)longueur : UINT32_MAX;
+    flot->symbole[k] = symbole;
 }
-void syn_analyzer(CSRmatrice *matrice, const char *input, TS *table)
+
+typedef struct
 {
-    int index = 0;
-    char current_lexeme[MAX_LEXEME_LENGTH];
-    LexemeType token_type;
-    Terminal current_terminal;
-    ParseStack stack;
+    char *donnees;
+    size_t taille;
+    size_t capacite;
+} TamponOctets;
+
+void ajouterOctets(TamponOctets *tampon, const void *donnees, size_t taille)
+{
+    if (taille == 0)
+        return;
+    if (tampon->taille + taille > tampon->capacite)
+    {
+        while (tampon->taille + taille > tampon->capacite)
+            tampon->capacite = tampon->capacite ? tampon->capacite * 2 : 4096;
+        tampon->donnees = realloc(tampon->donnees, tampon->capacite);
+    }
+    memcpy(tampon->donnees + tampon->taille, donnees, taille);
+    tampon->taille += taille;
+}
 
-    printf("\n--- ANALYSE SYNTAXIQUE LL(1) ---\n");
+// Diagnostic du jeton k, ajouté en une ligne à diagnostics : lexème non reconnu
+// (dont l'octet isolé qui ne démarre aucun lexème) ou nombre trop grand. Le texte
+// est cité s'il est encore en mémoire, sinon seul son offset est donné.
+void diagnostiquerJeton(const FlotJetons *flot, size_t k, const Source *src, const TS *table,
+                        TamponOctets *diagnostics)
+{
+    const char *erreur;
+    if (flot->type[k] == UNKNOWN)
+        erreur = "Lexeme non reconnu";
+    else if (flot->type[k] == NOMBRE && flot->symbole[k] >= 0 && table->entries[flot->symbole[k]].debordement)
+        erreur = "Nombre trop grand";
+    else
+        return;
 
-    // 0. Initialiser la pile avec $ et le symbole de départ E
-    initStack(&stack);
+    char message[128];
+    int64_t longueur = flot->longueur[k];
+    const char *lexeme = texteSource(src, flot->debut[k], longueur);
+    int taille;
+    // Un octet d'une séquence UTF-8 n'est pas affichable seul
+    if (lexeme != NULL && (longueur > 1 || (unsigned char)lexeme[0] < 0x80))
+        taille = snprintf(message, sizeof(message), "Erreur : %s - '%.*s'\n", erreur,
+                          (int)(longueur < 60 ? longueur : 60), lexeme);
+    else
+        taille = snprintf(message, sizeof(message), "Erreur : %s a l'offset %" PRId64 "\n", erreur, flot->debut[k]);
+    ajouterOctets(diagnostics, message, taille);
+}
 
-    // Obtenir le premier symbole (a = in.read())
-    token_type = lexical_analyzer(matrice, input, &index, table, current_lexeme);
-    current_terminal = convertToTerminal(token_type, current_lexeme);
-    printf("Token lu: %s (terminal: %d)\n", current_lexeme, current_terminal);
-    while (1)
+// Diagnostic de la validation UTF-8, une fois l'entrée entièrement lue
+void diagnostiquerUTF8(const Source *src, TamponOctets *diagnostics)
+{
+    if (src->erreurUTF8 >= 0)
     {
-        // Obtenir le symbole en haut de la pile (x = stack.top())
-        StackElement x = top(&stack);
+        char message[96];
+        ajouterOctets(diagnostics, message,
+                      snprintf(message, sizeof(message), "Erreur : Sequence UTF-8 invalide a l'offset %" PRId64 "\n",
+                               src->erreurUTF8));
+    }
+}
+
+// Écrit les diagnostics accumulés sur la sortie standard et vide le tampon
+void afficherDiagnostics(TamponOctets *diagnostics)
+{
+    if (diagnostics->taille > 0)
+        fwrite(diagnostics->donnees, 1, diagnostics->taille, stdout);
+    diagnostics->taille = 0;
+}
 
-        printf("Sommet de pile: ");
-        if (x.isTerminal)
+// Appels successifs au lexeur depuis index tant que l'appel commence avant limite ;
+// renvoie la position du prochain appel. *termine passe à true en fin d'entrée.
+// Un octet qui ne démarre aucun lexème devient un jeton UNKNOWN d'un octet et
+// l'analyse reprend après lui. Les jetons fautifs sont signalés dans diagnostics à
+// leur création, tant que leur texte est en mémoire (NULL : aucun diagnostic).
+int64_t tokenizeDepuis(CSRmatrice *matrice, Source *src, TS *table, FlotJetons *flot, int64_t index, int64_t limite,
+                       bool *termine, TamponOctets *diagnostics)
+{
+    *termine = false;
+    while (index < limite)
+    {
+        if (octetSource(src, index) == '\0')
         {
-            if (x.symbol.terminal == TERM_END)
-                printf("$ (fin)\n");
-            else
-                printf("Terminal %d\n", x.symbol.terminal);
+            *termine = true;
+            break;
+        }
+        int64_t debut;
+        int symbole;
+        Terminal terminal;
+        LexemeType type = lexical_analyzer(matrice, src, &index, table, &debut, &symbole, &terminal);
+        int64_t longueur = index - debut;
+
+        if (type == UNKNOWN && longueur == 0)
+        {
+            if (octetSource(src, index) == '\0')
+            {
+                *termine = true;
+                break; // blancs ou commentaire en fin d'entrée
+            }
+            longueur = 1;
+            index++;
         }
+        ajouterJeton(flot, type, terminal, debut, longueur, symbole);
+        if (diagnostics != NULL)
+            diagnostiquerJeton(flot, flot->nb - 1, src, table, diagnostics);
+    }
+    return index;
+}
+
+// Analyse lexicale de toute l'entrée en une passe
+size_t tokenize(CSRmatrice *matrice, Source *src, TS *table, FlotJetons *flot, TamponOctets *diagnostics)
+{
+    bool termine;
+    tokenizeDepuis(matrice, src, table, flot, 0, INT64_MAX, &termine, diagnostics);
+    if (diagnostics != NULL)
+        diagnostiquerUTF8(src, diagnostics);
+    return flot->nb;
+}
+
+// --- ANALYSE LEXICALE PARALLELE ---
+// L'entrée (entièrement en mémoire) est découpée en tranches. Chaque appel au
+// lexeur part de l'état 0 et son résultat ne dépend que de sa position de départ.
+// Pour chaque tranche, deux flots spéculatifs sont produits en parallèle : l'un
+// depuis le début de la tranche (hors commentaire), l'autre depuis la fin du
+// premier "*/" de la tranche (la tranche commence dans un commentaire). La passe
+// de raccord reprend à la position réelle du prochain appel et garde la suite d'un
+// flot spéculatif dès qu'un de ses appels part de cette position ; à défaut, elle
+// relance le lexeur elle-même jusqu'à se resynchroniser. Les identifiants de
+// symboles locaux sont renumérotés dans l'ordre de première apparition, comme
+// dans l'analyse séquentielle.
+#define TAILLE_TRANCHE_MIN (1024 * 1024)
+
+typedef struct
+{
+    int64_t depart; // position du premier appel, -1 si le flot n'existe pas
+    int64_t suivant; // position de l'appel qui suit le dernier jeton
+    bool termine;
+    FlotJetons flot;
+    TS table;
+    int32_t *global;  // identifiant local -> global, -1 tant que non attribué
+    int64_t jonction; // flot "commentaire" : jeton du flot "hors commentaire" qui le prolonge, -1 sinon
+} FlotSpeculatif;
+
+typedef struct
+{
+    CSRmatrice *matrice;
+    const Source *src;
+    int64_t tailleTranche;
+    int64_t nbTranches;
+    FlotSpeculatif *flots; // 2 par tranche : hors commentaire, dans un commentaire
+    _Atomic int64_t prochaine;
+} LexeurParallele;
+
+// Indice du jeton d'un flot spéculatif dont l'appel part de position, -1 sinon
+// (fs->flot.nb si position est celle qui suit le dernier jeton)
+int64_t chercherAppel(const FlotSpeculatif *fs, int64_t position)
+{
+    if (fs->depart < 0 || position < fs->depart || position > fs->suivant)
+        return -1;
+    if (position == fs->depart)
+        return 0;
+    // Les appels suivants partent de la fin du jeton précédent (positions croissantes)
+    size_t bas = 0, haut = fs->flot.nb;
+    while (bas < haut)
+    {
+        size_t milieu = (bas + haut) / 2;
+        int64_t finJeton = fs->flot.debut[milieu] + fs->flot.longueur[milieu];
+        if (finJeton < position)
+            bas = milieu + 1;
         else
+            haut = milieu;
+    }
+    if (bas < fs->flot.nb && fs->flot.debut[bas] + fs->flot.longueur[bas] == position)
+        return (int64_t)bas + 1;
+    return -1;
+}
+
+void *executerLexeurTranches(void *arg)
+{
+    LexeurParallele *lp = arg;
+    Source src = *lp->src; // copie privée (le lexeur modifie src->ancre)
+    int64_t t;
+    while ((t = atomic_fetch_add(&lp->prochaine, 1)) < lp->nbTranches)
+    {
+        int64_t debut = t * lp->tailleTranche;
+        int64_t fin = debut + lp->tailleTranche < src.longueur ? debut + lp->tailleTranche : src.longueur;
+
+        // Fin du premier "*/" dont l'étoile est dans la tranche
+        int64_t fermeture = -1;
+        const char *p = src.donnees + debut;
+        while ((p = memchr(p, '*', src.donnees + fin - p)) != NULL)
         {
-            printf("Non-terminal NT_%d\n", x.symbol.nt);
+            if (p[1] == '/')
+            {
+                fermeture = p + 2 - src.donnees;
+                break;
+            }
+            p++;
         }
 
-        // 1. Si x == $ et a == $, succès
-        if (x.isTerminal && x.symbol.terminal == TERM_END && current_terminal == TERM_END)
+        int64_t departs[2] = {debut, fermeture};
+        for (int c = 0; c < 2; c++)
         {
-            printf("Analyse syntaxique réussie!\n");
-            return;
+            FlotSpeculatif *fs = &lp->flots[2 * t + c];
+            fs->depart = departs[c];
+            initialiserFlot(&fs->flot);
+            initialiserTS(&fs->table);
+            fs->global = NULL;
+            fs->suivant = fs->depart;
+            fs->termine = false;
+            fs->jonction = -1;
         }
-        // 2. Si x est un terminal et x == a
-        if (x.isTerminal && x.symbol.terminal == current_terminal)
+
+        FlotSpeculatif *hors = &lp->flots[2 * t];
+        FlotSpeculatif *dans = &lp->flots[2 * t + 1];
+        hors->suivant = tokenizeDepuis(lp->matrice, &src, &hors->table, &hors->flot, debut, fin, &hors->termine, NULL);
+        // Le second flot s'arrête dès qu'un de ses appels rejoint le premier
+        while (dans->depart >= 0 && dans->suivant < fin && !dans->termine)
         {
-            // Match: depiler x et lire le prochain symbole
-            pop(&stack);
-            printf("Match: '%s'\n", current_lexeme);
+            dans->jonction = chercherAppel(hors, dans->suivant);
+            if (dans->jonction >= 0)
+                break;
+            dans->suivant = tokenizeDepuis(lp->matrice, &src, &dans->table, &dans->flot, dans->suivant,
+                                           dans->suivant + 1, &dans->termine, NULL);
+        }
+    }
+    return NULL;
+}
 
-            // a = in.read() - Lire le prochain symbole
-            if (input[index] != '\0')
-            {
-                token_type = lexical_analyzer(matrice, input, &index, table, current_lexeme);
-                current_terminal = convertToTerminal(token_type, current_lexeme);
-                printf("Token lu: %s (terminal: %d)\n", current_lexeme, current_terminal);
-            }
-            else
+// Recopie les jetons [k, nb) d'un flot spéculatif dans le flot final
+void raccorderFlot(LexeurParallele *lp, FlotSpeculatif *fs, size_t k, TS *table, FlotJetons *flot,
+                   TamponOctets *diagnostics)
+{
+    for (; k < fs->flot.nb; k++)
+    {
+        LexemeType type = fs->flot.type[k];
+        int symbole = fs->flot.symbole[k];
+        const char *lexeme = lp->src->donnees + fs->flot.debut[k];
+        if ((type == IDENTIFIER || type == NOMBRE) && symbole >= 0)
+        {
+            if (fs->global == NULL)
             {
-                current_terminal = TERM_END;
-                strcpy(current_lexeme, "$"); // la fin
-                printf("Fin de l'entrée atteinte \n ");
+                fs->global = malloc((fs->table.size ? fs->table.size : 1) * sizeof(int32_t));
+                memset(fs->global, 0xFF, fs->table.size * sizeof(int32_t));
             }
-            continue;
+            if (fs->global[symbole] < 0)
+                fs->global[symbole] = ajoutSymbole(table, lexeme, fs->flot.longueur[k], type);
+            symbole = fs->global[symbole];
         }
+        ajouterJeton(flot, type, fs->flot.terminal[k], fs->flot.debut[k], fs->flot.longueur[k], symbole);
+        // Diagnostic retenu pendant la spéculation (voir tokenizeDepuis)
+        if (diagnostics != NULL)
+            diagnostiquerJeton(flot, flot->nb - 1, lp->src, table, diagnostics);
+    }
+}
 
-        // 3. Si x est un non-terminal
-        else if (!x.isTerminal)
-        {
-            // Chercher la production dans la table M[x,a]
-            Production prod = parseTable[x.symbol.nt][current_terminal];
+// Même flot de jetons et même TS que tokenize, en nbThreads threads. Retombe sur
+// tokenize si l'entrée n'est pas entièrement en mémoire ou trop petite.
+size_t tokenizeParallele(CSRmatrice *matrice, Source *src, TS *table, FlotJetons *flot, int nbThreads,
+                         int64_t tailleTranche, TamponOctets *diagnostics)
+{
+    if (src->fd >= 0 || nbThreads < 1 || src->longueur <= tailleTranche)
+    {
+        return tokenize(matrice, src, table, flot, diagnostics);
+    }
 
-            if (prod == PROD_ERROR)
+    LexeurParallele lp;
+    lp.matrice = matrice;
+    lp.src = src;
+    lp.tailleTranche = tailleTranche;
+    lp.nbTranches = (src->longueur + tailleTranche - 1) / tailleTranche;
+    lp.flots = malloc(2 * lp.nbTranches * sizeof(FlotSpeculatif));
+    atomic_init(&lp.prochaine, 0);
+
+    pthread_t *threads = malloc(nbThreads * sizeof(pthread_t));
+    for (int w = 1; w < nbThreads; w++)
+        pthread_create(&threads[w], NULL, executerLexeurTranches, &lp);
+    executerLexeurTranches(&lp);
+    for (int w = 1; w < nbThreads; w++)
+        pthread_join(threads[w], NULL);
+    free(threads);
+
+    // Passe de raccord séquentielle
+    int64_t position = 0;
+    bool termine = false;
+    for (int64_t t = 0; t < lp.nbTranches && !termine; t++)
+    {
+        int64_t fin = (t + 1) * tailleTranche < src->longueur ? (t + 1) * tailleTranche : src->longueur;
+        while (position < fin && !termine)
+        {
+            FlotSpeculatif *choisi = NULL;
+            int64_t k = -1;
+            for (int c = 0; c < 2 && k < 0; c++)
             {
-                // M[x,a] est une erreur
-                printf("Erreur: Pas de production pour le non-terminal %d avec le terminal %d ('%s')\n",
-                       x.symbol.nt, current_terminal, current_lexeme);
+                choisi = &lp.flots[2 * t + c];
+                k = chercherAppel(choisi, position);
+            }
+            if (k >= 0)
+            {
+                raccorderFlot(&lp, choisi, (size_t)k, table, flot, diagnostics);
+                position = choisi->suivant;
+                termine = choisi->termine;
+                if (choisi->jonction >= 0)
+                {
+                    FlotSpeculatif *hors = &lp.flots[2 * t];
+                    raccorderFlot(&lp, hors, (size_t)choisi->jonction, table, flot, diagnostics);
+                    position = hors->suivant;
+                    termine = hors->termine;
+                }
                 break;
             }
-
-            // Appliquer la production
-            printf("Application de la production: ");
-            printProduction(prod);
-
-            applyProduction(&stack, prod);
-            continue;
+            // Pas encore resynchronisé : un appel au lexeur depuis la position réelle
+            position = tokenizeDepuis(matrice, src, table, flot, position, position + 1, &termine, diagnostics);
         }
+    }
 
-        printf("Erreur syntaxique: Terminal attendu %d, trouvé %d ('%s')\n",
-               x.symbol.terminal, current_terminal, current_lexeme);
-        break;
+    for (int64_t i = 0; i < 2 * lp.nbTranches; i++)
+    {
+        libererFlot(&lp.flots[i].flot);
+        libererTS(&lp.flots[i].table);
+        free(lp.flots[i].global);
     }
+    free(lp.flots);
+    if (diagnostics != NULL)
+        diagnostiquerUTF8(src, diagnostics);
+    return flot->nb;
+}
 
-    printf("--- FIN DE L'ANALYSE SYNTAXIQUE AVEC ERREUR ---\n");
+// Texte affichable du jeton k : la source si elle est encore en mémoire, sinon
+// l'entrée de la TS ; "$" après le dernier jeton
+const char *texteJeton(FlotJetons *flot, size_t k, Source *src, TS *table, int *longueur)
+{
+    if (k >= flot->nb)
+    {
+        *longueur = 1;
+        return "$";
+    }
+    const char *texte = texteSource(src, flot->debut[k], flot->longueur[k]);
+    if (texte != NULL)
+    {
+        *longueur = (int)flot->longueur[k];
+        return texte;
+    }
+    if (flot->type[k] == MOTCLES)
+    {
+        *longueur = motsCles[flot->symbole[k]].longueur;
+        return motsCles[flot->symbole[k]].texte;
+    }
+    if (flot->symbole[k] >= 0)
+    {
+        *longueur = (int)table->entries[flot->symbole[k]].longueur;
+        return lexemeSymbole(table, flot->symbole[k]);
+    }
+    *longueur = 1;
+    return "?";
 }
 
-int main()
+// --- TRACES ---
+// NIVEAU_TRACE=0 retire les traces à la compilation ; sinon elles ne sont
+// enregistrées qu'avec --trace, sous forme d'événements binaires dans un anneau
+// (les plus anciens sont écrasés), et mises en texte par afficherTrace à la fin.
+#ifndef NIVEAU_TRACE
+#define NIVEAU_TRACE 1
+#endif
+#define CAPACITE_TRACE (1 << 20) // événements, puissance de 2
+
+typedef enum
 {
-    CSRmatrice matrice;
-    initialiserMatrcie(&matrice);
+    EVT_JETON,      // a = terminal lu
+    EVT_PREDICTION, // a = non-terminal, b = production appliquée
+    EVT_MATCH,      // a = terminal consommé
+    EVT_ERREUR,     // a = 0 sans production, 1 terminal attendu, 2 pile pleine ; b = sommet
+    EVT_SUCCES
+} TypeEvenement;
 
-    TS table;
-    initialiserTS(&table);
+typedef struct
+{
+    uint8_t type;
+    uint8_t a;
+    uint8_t b;
+    uint32_t jeton; // indice du jeton courant dans le flot
+} Evenement;
+
+typedef struct
+{
+    Evenement *evenements;
+    uint64_t nb; // nombre total d'événements enregistrés
+} AnneauTrace;
 
-    const char *input = "10 + abc * (4 * 3) - alpha";
-    printf("Analyse de : %s\n", input);
+bool traceActive = false;
+AnneauTrace trace;
 
-    syn_analyzer(&matrice, input, &table);
+#if NIVEAU_TRACE > 0
+#define TRACER(t, x, y, k)                        \
+    do                                            \
+    {                                             \
+        if (traceActive)                          \
+            enregistrerEvenement(t, x, y, k);     \
+    } while (0)
+#else
+#define TRACER(t, x, y, k) ((void)0)
+#endif
 
-    afficherTS(&table);
-    return 0;
-}
\ No newline at end of file
+void activerTrace()
+{
+    trace.evenements = malloc(CAPACITE_TRACE * sizeof(Evenement));
+    trace.nb = 0;
+    traceActive = true;
+}
+
+void enregistrerEvenement(TypeEvenement type, int a, int b, size_t jeton)
+{
+    Evenement *e = &trace.evenements[trace.nb++ & (CAPACITE_TRACE - 1)];
+    e->type = (uint8_t)type;
+    e->a = (uint8_t)a;
+    e->b = (uint8_t)b;
+    e->jeton = (uint32_t)jeton;
+}
+
+// Met la trace en texte (format de l'ancienne sortie détaillée de syn_analyzer)
+void afficherTrace(FlotJetons *flot, Source *src, TS *table)
+{
+    uint64_t premier = trace.nb > CAPACITE_TRACE ? trace.nb - CAPACITE_TRACE : 0;
+    printf("\n--- TRACE (%" PRIu64 " evenements", trace.nb);
+    if (premier > 0)
+        printf(", %" PRIu64 " plus anciens perdus", premier);
+    printf(") ---\n");
+
+    for (uint64_t i = premier; i < trace.nb; i++)
+    {
+        const Evenement *e = &trace.evenements[i & (CAPACITE_TRACE - 1)];
+        int longueur;
+        const char *texte = texteJeton(flot, e->jeton, src, table, &longueur);
+        switch (e->type)
+        {
+        case EVT_JETON:
+            if (e->jeton < flot->nb)
+                printf("Token lu: %.*s (terminal: %d)\n", longueur, texte, e->a);
+            else
+                printf("Fin de l'entrée atteinte\n");
+            break;
+        case EVT_PREDICTION:
+            printf("Sommet de pile: Non-terminal NT_%d\n", e->a);
+            printf("Application de la production: ");
+            printProduction((Production)e->b);
+            break;
+        case EVT_MATCH:
+            printf("Match: '%.*s'\n", longueur, texte);
+            break;
+        case EVT_ERREUR:
+            if (e->a == 2)
+                printf("Erreur: pile pleine en developpant NT_%d devant '%.*s'\n", e->b, longueur, texte);
+            else if (e->a == 1)
+                printf("Erreur: terminal %d attendu, trouvé '%.*s'\n", e->b, longueur, texte);
+            else
+                printf("Erreur: pas de production pour NT_%d avec '%.*s'\n", e->b, longueur, texte);
+            break;
+        case EVT_SUCCES:
+            printf("Sommet de pile: $ (fin)\n");
+            break;
+        }
+    }
+    printf("---------------------------\n");
+}
+
+// --- ARBRE SYNTAXIQUE ---
+// Les noeuds sont alloués à la suite dans un tableau (arène) et désignés par leur
+// indice sur 32 bits ; reinitialiserArbre libère tout l'arbre en gardant la mémoire.
+#define AUCUN_NOEUD UINT32_MAX
+
+typedef struct
+{
+    uint8_t type;    // TypeNoeud
+    uint32_t gauche; // feuille : identifiant du symbole dans la TS
+    uint32_t droite;
+} Noeud;
+
+typedef struct
+{
+    Noeud *noeuds;
+    uint32_t nb;
+    uint32_t capacite;
+    uint32_t racine;
+    uint32_t *valeurs; // pile des sous-arbres en cours de construction
+    uint32_t nbValeurs;
+    uint32_t capaciteValeurs;
+} ArbreSyntaxe;
+
+void creerArbre(ArbreSyntaxe *arbre)
+{
+    memset(arbre, 0, sizeof(ArbreSyntaxe));
+    arbre->racine = AUCUN_NOEUD;
+}
+
+void reinitialiserArbre(ArbreSyntaxe *arbre)
+{
+    arbre->nb = 0;
+    arbre->nbValeurs = 0;
+    arbre->racine = AUCUN_NOEUD;
+}
+
+void libererArbre(ArbreSyntaxe *arbre)
+{
+    free(arbre->noeuds);
+    free(arbre->valeurs);
+    creerArbre(arbre);
+}
+
+void empilerValeur(ArbreSyntaxe *arbre, uint32_t noeud)
+{
+    if (arbre->nbValeurs == arbre->capaciteValeurs)
+    {
+        arbre->capaciteValeurs = arbre->capaciteValeurs ? arbre->capaciteValeurs * 2 : 64;
+        arbre->valeurs = realloc(arbre->valeurs, arbre->capaciteValeurs * sizeof(uint32_t));
+    }
+    arbre->valeurs[arbre->nbValeurs++] = noeud;
+}
+
+// Alloue un noeud et empile son indice
+uint32_t nouveauNoeud(ArbreSyntaxe *arbre, TypeNoeud type, uint32_t gauche, uint32_t droite)
+{
+    if (arbre->nb == arbre->capacite)
+    {
+        arbre->capacite = arbre->capacite ? arbre->capacite * 2 : 256;
+        arbre->noeuds = realloc(arbre->noeuds, arbre->capacite * sizeof(Noeud));
+    }
+    uint32_t n = arbre->nb++;
+    arbre->noeuds[n].type = (uint8_t)type;
+    arbre->noeuds[n].gauche = gauche;
+    arbre->noeuds[n].droite = droite;
+    empilerValeur(arbre, n);
+    return n;
+}
+
+static const char *operateursNoeuds[NB_TYPES_NOEUDS] = {"", "+", "*", "-", "/", "mod", "<", "<=", ">", ">=", "==",
+                                                        "="};
+
+// Affiche l'arbre en notation préfixe parenthésée
+void afficherNoeud(ArbreSyntaxe *arbre, uint32_t n, TS *table)
+{
+    const Noeud *noeud = &arbre->noeuds[n];
+    if (noeud->type == NOEUD_FEUILLE)
+    {
+        printf("%s", lexemeSymbole(table, noeud->gauche));
+        return;
+    }
+    printf("(%s ", operateursNoeuds[noeud->type]);
+    afficherNoeud(arbre, noeud->gauche, table);
+    printf(" ");
+    afficherNoeud(arbre, noeud->droite, table);
+    printf(")");
+}
+
+typedef enum
+{
+    ANALYSE_REUSSIE,
+    ERREUR_PRODUCTION, // pas de production pour le non-terminal en sommet de pile
+    ERREUR_TERMINAL,   // terminal en sommet de pile différent du jeton lu
+    ERREUR_PILE_PLEINE, // limite de profondeur de la pile atteinte
+    ANALYSE_SUSPENDUE   // jeton d'arrêt atteint (voir poursuivreLL1)
+} ResultatAnalyse;
+
+size_t profondeurPileMax = PROFONDEUR_PILE_MAX;
+
+// Boucle LL(1) sur le flot de jetons à partir du jeton *jeton, avec la pile telle
+// qu'elle est. S'arrête au résultat de l'analyse, ou avec ANALYSE_SUSPENDUE quand le
+// jeton arret devient le jeton courant. *jeton reçoit alors l'indice du jeton courant
+// et *attendu le sommet de pile. Si arbre n'est pas NULL, l'arbre syntaxique y est
+// construit (arbre->racine en cas de succès).
+ResultatAnalyse poursuivreLL1(FlotJetons *flot, ParseStack *stack, ArbreSyntaxe *arbre, size_t *jeton,
+                              StackElement *attendu, size_t arret)
+{
+    size_t k = *jeton;
+    Terminal current_terminal;
+
+    // Obtenir le premier symbole (a = in.read())
+    current_terminal = k < flot->nb ? flot->terminal[k] : TERM_END;
+    TRACER(EVT_JETON, current_terminal, 0, k);
+    while (1)
+    {
+        // Obtenir le symbole en haut de la pile (x = stack.top())
+        StackElement x = top(stack);
+        *jeton = k;
+        *attendu = x;
+
+        // 1. Si x == $ et a == $, succès
+        if (x == TERM_END && current_terminal == TERM_END)
+        {
+            TRACER(EVT_SUCCES, 0, 0, k);
+            if (arbre != NULL)
+                arbre->racine = arbre->valeurs[0];
+            return ANALYSE_REUSSIE;
+        }
+        // Action : l'opérande droit vient d'être reconnu, construire le noeud
+        if (estAction(x))
+        {
+            pop(stack);
+            uint32_t droite = arbre->valeurs[--arbre->nbValeurs];
+            uint32_t gauche = arbre->valeurs[--arbre->nbValeurs];
+            nouveauNoeud(arbre, symboleDe(x), gauche, droite);
+            continue;
+        }
+        // 2. Si x est un terminal et x == a
+        if (x == current_terminal)
+        {
+            // Match: depiler x et lire le prochain symbole
+            pop(stack);
+            TRACER(EVT_MATCH, current_terminal, 0, k);
+            if (arbre != NULL && current_terminal == TERM_N)
+                nouveauNoeud(arbre, NOEUD_FEUILLE, (uint32_t)flot->symbole[k], 0);
+
+            // a = in.read() - Lire le prochain symbole
+            k++;
+            // Suspendue, l'analyse tracera ce jeton à la reprise, une fois lu
+            if (k == arret)
+            {
+                *jeton = k;
+                *attendu = top(stack);
+                return ANALYSE_SUSPENDUE;
+            }
+            current_terminal = k < flot->nb ? flot->terminal[k] : TERM_END;
+            TRACER(EVT_JETON, current_terminal, 0, k);
+            continue;
+        }
+
+        // 3. Si x est un non-terminal
+        else if (!estTerminal(x))
+        {
+            // Chercher la production dans la table M[x,a]
+            Production prod = parseTable[symboleDe(x)][current_terminal];
+
+            if (prod == PROD_ERROR)
+            {
+                // M[x,a] est une erreur
+                TRACER(EVT_ERREUR, 0, symboleDe(x), k);
+                return ERREUR_PRODUCTION;
+            }
+
+            // Appliquer la production
+            TRACER(EVT_PREDICTION, symboleDe(x), prod, k);
+            if (!applyProduction(stack, prod, arbre != NULL))
+            {
+                TRACER(EVT_ERREUR, 2, symboleDe(x), k);
+                return ERREUR_PILE_PLEINE;
+            }
+            continue;
+        }
+
+        TRACER(EVT_ERREUR, 1, x, k);
+        return ERREUR_TERMINAL;
+    }
+}
+
+// Analyse LL(1) complète du flot ; en cas d'erreur, *jetonErreur reçoit l'indice du
+// jeton courant et *attendu le sommet de pile
+ResultatAnalyse analyserLL1(FlotJetons *flot, ParseStack *stack, ArbreSyntaxe *arbre, size_t *jetonErreur,
+                            StackElement *attendu)
+{
+    // 0. Initialiser la pile avec $ et le symbole de départ E
+    initStack(stack);
+    if (arbre != NULL)
+        reinitialiserArbre(arbre);
+
+    *jetonErreur = 0;
+    return poursuivreLL1(flot, stack, arbre, jetonErreur, attendu, SIZE_MAX);
+}
+
+// --- MOTEUR PRATT ---
+// Analyse par précédence des opérateurs, sans non-terminaux : les opérandes
+// (feuilles et sous-arbres) s'accumulent dans la pile de valeurs de l'arbre, les
+// opérateurs et parenthèses en attente dans la pile d'analyse. Un opérateur lu
+// réduit d'abord ceux de la pile qui lient plus fort (ou autant, s'il est associatif
+// à gauche). Les expressions acceptées par la grammaire LL(1) donnent le même arbre.
+
+// Précédence des opérateurs binaires (0 : pas un opérateur binaire)
+static const uint8_t precedence[NB_TERMINAUX] = {
+    [TERM_AFFECTATION] = 1, // associatif à droite
+    [TERM_EGAL] = 2,
+    [TERM_INF] = 3,
+    [TERM_INF_EGAL] = 3,
+    [TERM_SUP] = 3,
+    [TERM_SUP_EGAL] = 3,
+    [TERM_PLUS] = 4,
+    [TERM_MOINS] = 4,
+    [TERM_MULT] = 5,
+    [TERM_DIV] = 5,
+    [TERM_MOD] = 5,
+};
+
+static const uint8_t noeudOperateur[NB_TERMINAUX] = {
+    [TERM_PLUS] = NOEUD_PLUS,
+    [TERM_MULT] = NOEUD_MULT,
+    [TERM_MOINS] = NOEUD_MOINS,
+    [TERM_DIV] = NOEUD_DIV,
+    [TERM_MOD] = NOEUD_MOD,
+    [TERM_INF] = NOEUD_INF,
+    [TERM_INF_EGAL] = NOEUD_INF_EGAL,
+    [TERM_SUP] = NOEUD_SUP,
+    [TERM_SUP_EGAL] = NOEUD_SUP_EGAL,
+    [TERM_EGAL] = NOEUD_EGAL,
+    [TERM_AFFECTATION] = NOEUD_AFFECTATION,
+};
+
+// Dépile l'opérateur en sommet et construit son noeud avec les deux derniers opérandes
+void reduireOperateur(ParseStack *stack, ArbreSyntaxe *arbre)
+{
+    StackElement op = pop(stack);
+    if (arbre != NULL)
+    {
+        uint32_t droite = arbre->valeurs[--arbre->nbValeurs];
+        uint32_t gauche = arbre->valeurs[--arbre->nbValeurs];
+        nouveauNoeud(arbre, noeudOperateur[op], gauche, droite);
+    }
+}
+
+// La cible d'une affectation est un identificateur seul : le jeton qui précède '='
+// est un identificateur en début d'expression, après '(' ou après un autre '='
+bool cibleAffectation(FlotJetons *flot, size_t k)
+{
+    if (k == 0 || flot->type[k - 1] != IDENTIFIER)
+        return false;
+    return k == 1 || flot->terminal[k - 2] == TERM_PAREN_OPEN || flot->terminal[k - 2] == TERM_AFFECTATION;
+}
+
+// Même contrat que analyserLL1. En cas d'erreur, *attendu vaut NON_TERMINAL(NT_E)
+// si un opérande manquait, NON_TERMINAL(NT_TPRIME) si un opérateur manquait et
+// TERM_PAREN_CLOSE si une parenthèse n'est pas fermée.
+ResultatAnalyse analyserPratt(FlotJetons *flot, ParseStack *stack, ArbreSyntaxe *arbre, size_t *jetonErreur,
+                              StackElement *attendu)
+{
+    stack->top = 0;
+    stack->profondeurMax = 0;
+    push(stack, TERM_END);
+    if (arbre != NULL)
+        reinitialiserArbre(arbre);
+
+    size_t k = 0;
+    bool operande = true; // un opérande est attendu
+    while (1)
+    {
+        Terminal t = k < flot->nb ? flot->terminal[k] : TERM_END;
+        *jetonErreur = k;
+        if (operande)
+        {
+            if (t == TERM_N)
+            {
+                if (arbre != NULL)
+                    nouveauNoeud(arbre, NOEUD_FEUILLE, (uint32_t)flot->symbole[k], 0);
+                operande = false;
+            }
+            else if (t == TERM_PAREN_OPEN)
+            {
+                if (!push(stack, TERM_PAREN_OPEN))
+                    return ERREUR_PILE_PLEINE;
+            }
+            else
+            {
+                *attendu = NON_TERMINAL(NT_E);
+                return ERREUR_PRODUCTION;
+            }
+            k++;
+            continue;
+        }
+
+        uint8_t p = precedence[t];
+        if (p > 0)
+        {
+            if (t == TERM_AFFECTATION && !cibleAffectation(flot, k))
+            {
+                *attendu = NON_TERMINAL(NT_TPRIME);
+                return ERREUR_PRODUCTION;
+            }
+            // '=' est associatif à droite : il ne réduit pas un '=' en attente
+            StackElement sommet;
+            while ((sommet = top(stack)) != TERM_END && sommet != TERM_PAREN_OPEN &&
+                   (precedence[sommet] > p || (precedence[sommet] == p && t != TERM_AFFECTATION)))
+            {
+                reduireOperateur(stack, arbre);
+            }
+            if (!push(stack, t))
+                return ERREUR_PILE_PLEINE;
+            operande = true;
+            k++;
+            continue;
+        }
+
+        if (t != TERM_PAREN_CLOSE && t != TERM_END)
+        {
+            *attendu = NON_TERMINAL(NT_TPRIME);
+            return ERREUR_PRODUCTION;
+        }
+        StackElement sommet;
+        while ((sommet = top(stack)) != TERM_END && sommet != TERM_PAREN_OPEN)
+        {
+            reduireOperateur(stack, arbre);
+        }
+        if (t == TERM_END)
+        {
+            if (sommet == TERM_PAREN_OPEN)
+            {
+                *attendu = TERM_PAREN_CLOSE;
+                return ERREUR_TERMINAL;
+            }
+            if (arbre != NULL)
+                arbre->racine = arbre->valeurs[0];
+            return ANALYSE_REUSSIE;
+        }
+        if (sommet != TERM_PAREN_OPEN)
+        {
+            *attendu = TERM_END;
+            return ERREUR_TERMINAL;
+        }
+        pop(stack);
+        k++;
+    }
+}
+
+// Moteur d'analyse syntaxique choisi au lancement (--pratt)
+typedef ResultatAnalyse (*MoteurAnalyse)(FlotJetons *, ParseStack *, ArbreSyntaxe *, size_t *, StackElement *);
+MoteurAnalyse moteurAnalyse = analyserLL1;
+
+// --- ANALYSE EN PIPELINE ---
+// Le lexeur tourne dans son propre thread et publie les jetons par lots dans un
+// anneau à un producteur et un consommateur, sans verrou : seul le lexeur avance
+// tete et seul l'analyseur avance queue (compteurs jamais ramenés modulo la
+// taille ; tete - queue jetons sont en attente). Chaque côté garde une copie de
+// l'indice de l'autre et ne le relit que lorsqu'il semble bloqué. L'analyseur
+// recopie les jetons publiés dans son flot et reprend poursuivreLL1 jusqu'au
+// dernier. Un anneau plein fait attendre le lexeur (contre-pression) ; la fin
+// de l'analyse (erreur comprise) lève abandon et le lexeur s'arrête au lot suivant. Le moteur
+// Pratt ne sait pas se suspendre : il ne démarre qu'en fin d'entrée.
+#define TAILLE_ANNEAU 16384  // jetons, puissance de 2
+#define OCTETS_PAR_LOT 16384 // texte lexé entre deux publications
+#define ATTENTES_ACTIVES 64  // tours d'attente active avant de céder le processeur
+
+// Jetons rangés comme dans FlotJetons (structure de tableaux) : les lots sont
+// recopiés tableau par tableau
+typedef struct
+{
+    int64_t debut[TAILLE_ANNEAU];
+    uint32_t longueur[TAILLE_ANNEAU];
+    int32_t symbole[TAILLE_ANNEAU];
+    unsigned char type[TAILLE_ANNEAU];
+    unsigned char terminal[TAILLE_ANNEAU];
+    // Indices sur des lignes de cache distinctes : pas de faux partage
+    _Alignas(64) atomic_size_t tete; // prochain jeton écrit par le lexeur
+    _Alignas(64) atomic_size_t queue; // prochain jeton lu par l'analyseur
+    _Alignas(64) atomic_bool fini;    // le dernier jeton est publié
+    atomic_bool abandon;              // l'analyseur n'attend plus de jetons
+} AnneauJetons;
+
+typedef struct
+{
+    AnneauJetons *anneau;
+    CSRmatrice *matrice;
+    Source *src;
+    TS *table;
+    TamponOctets *diagnostics; // écrit par le lexeur, lu après sa fin
+} LexeurPipeline;
+
+void attendreAnneau(unsigned *attentes)
+{
+    if (++*attentes < ATTENTES_ACTIVES)
+    {
+#if defined(__AVX2__) || defined(__SSE2__)
+        _mm_pause();
+#endif
+    }
+    else
+    {
+        sched_yield();
+    }
+}
+
+// Copie n jetons de source (à partir de i) vers destination (à partir de j) ;
+// les indices de l'anneau sont pris modulo sa taille par l'appelant
+#define COPIER_JETONS(destination, j, source, i, n)                                   \
+    do                                                                               \
+    {                                                                                \
+        memcpy((destination)->debut + (j), (source)->debut + (i), (n) * sizeof(int64_t)); \
+        memcpy((destination)->longueur + (j), (source)->longueur + (i), (n) * sizeof(uint32_t)); \
+        memcpy((destination)->symbole + (j), (source)->symbole + (i), (n) * sizeof(int32_t)); \
+        memcpy((destination)->type + (j), (source)->type + (i), (n));                 \
+        memcpy((destination)->terminal + (j), (source)->terminal + (i), (n));         \
+    } while (0)
+
+void *executerLexeurPipeline(void *arg)
+{
+    LexeurPipeline *lexeur = arg;
+    AnneauJetons *anneau = lexeur->anneau;
+    FlotJetons lot;
+    initialiserFlot(&lot);
+    size_t tete = 0, queue = 0;
+    int64_t index = 0;
+    bool termine = false;
+    while (!termine && !atomic_load_explicit(&anneau->abandon, memory_order_relaxed))
+    {
+        lot.nb = 0;
+        index = tokenizeDepuis(lexeur->matrice, lexeur->src, lexeur->table, &lot, index, index + OCTETS_PAR_LOT,
+                               &termine, lexeur->diagnostics);
+        for (size_t j = 0; j < lot.nb;)
+        {
+            unsigned attentes = 0;
+            while (tete - queue == TAILLE_ANNEAU)
+            {
+                queue = atomic_load_explicit(&anneau->queue, memory_order_acquire);
+                if (tete - queue < TAILLE_ANNEAU)
+                    break;
+                if (atomic_load_explicit(&anneau->abandon, memory_order_relaxed))
+                    goto fin;
+                attendreAnneau(&attentes);
+            }
+            // Jusqu'à la place libre, sans franchir la fin du tableau
+            size_t position = tete & (TAILLE_ANNEAU - 1);
+            size_t n = TAILLE_ANNEAU - (tete - queue);
+            if (n > TAILLE_ANNEAU - position)
+                n = TAILLE_ANNEAU - position;
+            if (n > lot.nb - j)
+                n = lot.nb - j;
+            COPIER_JETONS(anneau, position, &lot, j, n);
+            j += n;
+            tete += n;
+            atomic_store_explicit(&anneau->tete, tete, memory_order_release);
+        }
+    }
+    if (lexeur->diagnostics != NULL)
+        diagnostiquerUTF8(lexeur->src, lexeur->diagnostics);
+fin:
+    atomic_store_explicit(&anneau->fini, true, memory_order_release);
+    libererFlot(&lot);
+    return NULL;
+}
+
+// Lexe src dans un thread pendant que moteurAnalyse consomme les jetons ; même
+// résultat que tokenize suivi de moteurAnalyse, mais le flot et la TS s'arrêtent
+// peu après le jeton où l'analyse se termine. La TS n'appartient au lexeur que
+// pendant l'appel, de même que diagnostics.
+ResultatAnalyse analyserPipeline(CSRmatrice *matrice, Source *src, TS *table, FlotJetons *flot, ParseStack *stack,
+                                 ArbreSyntaxe *arbre, size_t *jeton, StackElement *attendu, TamponOctets *diagnostics)
+{
+    AnneauJetons *anneau = aligned_alloc(64, sizeof(AnneauJetons));
+    atomic_init(&anneau->tete, 0);
+    atomic_init(&anneau->queue, 0);
+    atomic_init(&anneau->fini, false);
+    atomic_init(&anneau->abandon, false);
+    LexeurPipeline lexeur = {anneau, matrice, src, table, diagnostics};
+    pthread_t thread;
+    pthread_create(&thread, NULL, executerLexeurPipeline, &lexeur);
+
+    bool ll1 = moteurAnalyse == analyserLL1;
+    initStack(stack);
+    if (arbre != NULL)
+        reinitialiserArbre(arbre);
+    *jeton = 0;
+    flot->nb = 0;
+    size_t queue = 0;
+    unsigned attentes = 0;
+    ResultatAnalyse resultat = ANALYSE_SUSPENDUE;
+    while (resultat == ANALYSE_SUSPENDUE)
+    {
+        // fini est lu avant tete : une fois fini vu, tete est définitif
+        bool fini = atomic_load_explicit(&anneau->fini, memory_order_acquire);
+        size_t tete = atomic_load_explicit(&anneau->tete, memory_order_acquire);
+        if (tete == queue && !fini)
+        {
+            attendreAnneau(&attentes);
+            continue;
+        }
+        attentes = 0;
+        reserverJetons(flot, flot->nb + (tete - queue));
+        while (queue < tete)
+        {
+            size_t position = queue & (TAILLE_ANNEAU - 1);
+            size_t n = tete - queue < TAILLE_ANNEAU - position ? tete - queue : TAILLE_ANNEAU - position;
+            COPIER_JETONS(flot, flot->nb, anneau, position, n);
+            flot->nb += n;
+            queue += n;
+        }
+        atomic_store_explicit(&anneau->queue, queue, memory_order_release);
+
+        if (ll1 && (flot->nb > *jeton || fini))
+            resultat = poursuivreLL1(flot, stack, arbre, jeton, attendu, fini ? SIZE_MAX : flot->nb);
+        else if (!ll1 && fini)
+            resultat = moteurAnalyse(flot, stack, arbre, jeton, attendu);
+    }
+
+    atomic_store_explicit(&anneau->abandon, true, memory_order_relaxed);
+    pthread_join(thread, NULL);
+    free(anneau);
+    return resultat;
+}
+
+// Message d'une erreur d'analyse (k : jeton courant, x : sommet de pile), vide
+// si l'analyse a réussi
+void formaterErreurSyntaxe(char *message, size_t taille, ResultatAnalyse resultat, FlotJetons *flot, size_t k,
+                           StackElement x, size_t limite, Source *src, TS *table)
+{
+    int current_length;
+    Terminal current_terminal = k < flot->nb ? flot->terminal[k] : TERM_END;
+    const char *current_lexeme = texteJeton(flot, k, src, table, &current_length);
+    message[0] = '\0';
+
+    switch (resultat)
+    {
+    case ERREUR_PRODUCTION:
+        snprintf(message, taille, "Erreur: Pas de production pour le non-terminal %d avec le terminal %d ('%.*s')",
+                 symboleDe(x), current_terminal, current_length, current_lexeme);
+        break;
+    case ERREUR_TERMINAL:
+        snprintf(message, taille, "Erreur syntaxique: Terminal attendu %d, trouvé %d ('%.*s')", x,
+                 current_terminal, current_length, current_lexeme);
+        break;
+    case ERREUR_PILE_PLEINE:
+        snprintf(message, taille, "Erreur: Profondeur de pile limitee a %zu symboles, depassee au jeton %zu ('%.*s')",
+                 limite, k, current_length, current_lexeme);
+        break;
+    case ANALYSE_REUSSIE:
+    case ANALYSE_SUSPENDUE:
+        break;
+    }
+}
+
+// Avec pipeline, le flot est produit pendant l'analyse par un thread lexeur
+// (voir analyserPipeline) et ses diagnostics sont affichés à la fin de l'analyse ;
+// sinon il est déjà complet
+void syn_analyzer(FlotJetons *flot, Source *src, TS *table, CSRmatrice *pipeline, TamponOctets *diagnostics)
+{
+    ParseStack stack;
+    size_t k;
+    StackElement x;
+
+    printf("\n--- ANALYSE SYNTAXIQUE %s ---\n", moteurAnalyse == analyserPratt ? "PRATT" : "LL(1)");
+
+    ArbreSyntaxe arbre;
+    creerArbre(&arbre);
+    creerPile(&stack, profondeurPileMax);
+    ResultatAnalyse resultat = pipeline != NULL
+                                   ? analyserPipeline(pipeline, src, table, flot, &stack, &arbre, &k, &x, diagnostics)
+                                   : moteurAnalyse(flot, &stack, &arbre, &k, &x);
+    afficherDiagnostics(diagnostics);
+
+    if (resultat == ANALYSE_REUSSIE)
+    {
+        printf("Analyse syntaxique réussie!\n");
+        // Au-delà, l'arbre n'est pas affiché (afficherNoeud est récursif)
+        if (arbre.nb <= 64)
+        {
+            printf("Arbre: ");
+            afficherNoeud(&arbre, arbre.racine, table);
+            printf("\n");
+        }
+        else
+        {
+            printf("Arbre: %u noeuds\n", arbre.nb);
+        }
+    }
+    else if (resultat != ANALYSE_SUSPENDUE)
+    {
+        char message[256];
+        formaterErreurSyntaxe(message, sizeof(message), resultat, flot, k, x, stack.limite, src, table);
+        printf("%s\n", message);
+    }
+    printf("Profondeur maximale de pile: %zu\n", stack.profondeurMax);
+    if (resultat != ANALYSE_REUSSIE)
+        printf("--- FIN DE L'ANALYSE SYNTAXIQUE AVEC ERREUR ---\n");
+    libererPile(&stack);
+    libererArbre(&arbre);
+}
+
+// --- ANALYSE INCREMENTALE ---
+// Un document est découpé en blocs d'environ JETONS_PAR_BLOC jetons. Un bloc
+// commence à l'appel au lexeur qui produit son premier jeton (un appel part
+// toujours de l'état 0, hors commentaire) et garde son texte, ses jetons (debut
+// relatif au bloc) et un point de reprise de l'analyse LL(1) : la pile quand son
+// premier jeton devient courant. L'origine d'un bloc et le rang de son premier
+// jeton sont des sommes de préfixes tenues dans deux arbres de Fenwick.
+// Après une modification, le lexeur repart du début du bloc touché et s'arrête dès
+// qu'un appel retombe, décalé, sur un appel de l'ancien flot : seuls les blocs
+// parcourus sont recréés. L'analyse repart de la reprise du premier bloc recréé et
+// s'arrête dès que sa pile retrouve la reprise d'un ancien bloc situé après : la
+// suite de l'analyse est alors inchangée. Les symboles ne sont jamais retirés de
+// la TS. L'arbre syntaxique n'est pas construit dans ce mode.
+#define JETONS_PAR_BLOC 256
+#define PROFONDEUR_REPRISE_MAX 4096 // au-delà, la pile n'est pas sauvegardée
+
+typedef struct
+{
+    char *texte; // octets [origine, origine + taille) du document
+    int64_t taille;
+    FlotJetons flot;       // debut relatif à l'origine du bloc
+    StackElement *reprise; // NULL : pile trop profonde, ou bloc pas encore analysé
+    uint32_t profondeur;
+} BlocDocument;
+
+typedef struct
+{
+    BlocDocument **blocs; // jamais vide ; seul un document sans jeton a un bloc sans jeton
+    size_t nbBlocs;
+    int64_t *octets; // arbres de Fenwick des tailles et des nombres de jetons des blocs
+    int64_t *jetons;
+    int64_t longueur;
+    size_t nbJetons;
+    CSRmatrice *matrice;
+    TS table;
+    ParseStack stack;
+    ResultatAnalyse resultat;
+    size_t blocFin;  // bloc où la dernière analyse s'est arrêtée (reprises périmées au-delà)
+    size_t jetonFin; // jeton courant dans ce bloc à l'arrêt
+    StackElement attendu;
+} Document;
+
+// Arbre de Fenwick sur n valeurs : arbre[i - 1] est la somme des valeurs
+// [i - (i & -i), i). Construction en place à partir des valeurs.
+void construireFenwick(int64_t *arbre, size_t n)
+{
+    for (size_t i = 1; i <= n; i++)
+    {
+        size_t parent = i + (i & -i);
+        if (parent <= n)
+            arbre[parent - 1] += arbre[i - 1];
+    }
+}
+
+void ajouterFenwick(int64_t *arbre, size_t n, size_t i, int64_t valeur)
+{
+    for (i++; i <= n; i += i & -i)
+        arbre[i - 1] += valeur;
+}
+
+// Somme des valeurs [0, i)
+int64_t prefixeFenwick(const int64_t *arbre, size_t i)
+{
+    int64_t somme = 0;
+    for (; i > 0; i &= i - 1)
+        somme += arbre[i - 1];
+    return somme;
+}
+
+// Plus grand i dont la somme des valeurs [0, i) est <= valeur (valeurs positives)
+size_t chercherFenwick(const int64_t *arbre, size_t n, int64_t valeur)
+{
+    size_t pas = 1;
+    while (pas * 2 <= n)
+        pas *= 2;
+    size_t i = 0;
+    for (; pas > 0; pas /= 2)
+    {
+        if (i + pas <= n && arbre[i + pas - 1] <= valeur)
+        {
+            i += pas;
+            valeur -= arbre[i - 1];
+        }
+    }
+    return i;
+}
+
+// Reconstruit les deux arbres après un changement du nombre de blocs
+void indexerBlocs(Document *doc)
+{
+    doc->octets = realloc(doc->octets, doc->nbBlocs * sizeof(int64_t));
+    doc->jetons = realloc(doc->jetons, doc->nbBlocs * sizeof(int64_t));
+    for (size_t i = 0; i < doc->nbBlocs; i++)
+    {
+        doc->octets[i] = doc->blocs[i]->taille;
+        doc->jetons[i] = (int64_t)doc->blocs[i]->flot.nb;
+    }
+    construireFenwick(doc->octets, doc->nbBlocs);
+    construireFenwick(doc->jetons, doc->nbBlocs);
+}
+
+int64_t origineBloc(const Document *doc, size_t i)
+{
+    return prefixeFenwick(doc->octets, i);
+}
+
+// Bloc qui contient l'octet offset (le dernier pour la fin du document)
+size_t blocDocument(const Document *doc, int64_t offset)
+{
+    size_t i = chercherFenwick(doc->octets, doc->nbBlocs, offset);
+    return i < doc->nbBlocs ? i : doc->nbBlocs - 1;
+}
+
+// Indice (dans tout le document) du jeton courant à la fin de la dernière analyse
+size_t jetonErreurDocument(const Document *doc)
+{
+    return (size_t)prefixeFenwick(doc->jetons, doc->blocFin) + doc->jetonFin;
+}
+
+// Copie au plus taille octets du texte depuis position ; renvoie le nombre copié
+size_t lireDocument(const Document *doc, int64_t position, char *destination, size_t taille)
+{
+    if (position >= doc->longueur)
+        return 0;
+    size_t i = blocDocument(doc, position);
+    int64_t relatif = position - origineBloc(doc, i);
+    size_t lus = 0;
+    for (; i < doc->nbBlocs && lus < taille; i++, relatif = 0)
+    {
+        const BlocDocument *bloc = doc->blocs[i];
+        size_t n = (size_t)(bloc->taille - relatif);
+        if (n > taille - lus)
+            n = taille - lus;
+        memcpy(destination + lus, bloc->texte + relatif, n);
+        lus += n;
+    }
+    return lus;
+}
+
+// Copie du texte entier (terminée par '\0')
+char *texteDocument(const Document *doc)
+{
+    char *texte = malloc(doc->longueur + 1);
+    lireDocument(doc, 0, texte, doc->longueur);
+    texte[doc->longueur] = '\0';
+    return texte;
+}
+
+// Fin du jeton k (position de l'appel suivant au lexeur)
+int64_t finJeton(const FlotJetons *flot, size_t k)
+{
+    return flot->debut[k] + flot->longueur[k];
+}
+
+// Ajoute à flot les n jetons de source à partir de premier, debut décalé de decalage
+void ajouterJetons(FlotJetons *flot, const FlotJetons *source, size_t premier, size_t n, int64_t decalage)
+{
+    if (n == 0)
+        return;
+    reserverJetons(flot, flot->nb + n);
+    memcpy(flot->type + flot->nb, source->type + premier, n);
+    memcpy(flot->terminal + flot->nb, source->terminal + premier, n);
+    memcpy(flot->longueur + flot->nb, source->longueur + premier, n * sizeof(uint32_t));
+    memcpy(flot->symbole + flot->nb, source->symbole + premier, n * sizeof(int32_t));
+    for (size_t k = 0; k < n; k++)
+        flot->debut[flot->nb + k] = source->debut[premier + k] + decalage;
+    flot->nb += n;
+}
+
+// Tous les jetons du document, debut absolu
+void jetonsDocument(const Document *doc, FlotJetons *flot)
+{
+    initialiserFlot(flot);
+    int64_t origine = 0;
+    for (size_t i = 0; i < doc->nbBlocs; i++)
+    {
+        ajouterJetons(flot, &doc->blocs[i]->flot, 0, doc->blocs[i]->flot.nb, origine);
+        origine += doc->blocs[i]->taille;
+    }
+}
+
+// Répartit les jetons (debut absolu) en nb blocs qui couvrent le texte
+// [origine, fin) ; texte[0] est l'octet d'offset origine
+void decouperBlocs(const FlotJetons *jetons, const char *texte, int64_t origine, int64_t fin, size_t nb,
+                   BlocDocument **blocs)
+{
+    int64_t debutBloc = origine;
+    for (size_t i = 0; i < nb; i++)
+    {
+        size_t premier = i * jetons->nb / nb, suivant = (i + 1) * jetons->nb / nb;
+        int64_t finBloc = i + 1 < nb ? finJeton(jetons, suivant - 1) : fin;
+        BlocDocument *bloc = calloc(1, sizeof(BlocDocument));
+        bloc->taille = finBloc - debutBloc;
+        bloc->texte = malloc(bloc->taille + 1);
+        memcpy(bloc->texte, texte + (debutBloc - origine), bloc->taille);
+
+        // Flot alloué au plus juste : il n'est plus modifié, seulement remplacé
+        FlotJetons *flot = &bloc->flot;
+        flot->capacite = suivant - premier;
+        flot->type = malloc(flot->capacite + 1);
+        flot->terminal = malloc(flot->capacite + 1);
+        flot->debut = malloc((flot->capacite + 1) * sizeof(int64_t));
+        flot->longueur = malloc((flot->capacite + 1) * sizeof(uint32_t));
+        flot->symbole = malloc((flot->capacite + 1) * sizeof(int32_t));
+        ajouterJetons(flot, jetons, premier, suivant - premier, -debutBloc);
+        blocs[i] = bloc;
+        debutBloc = finBloc;
+    }
+}
+
+void libererBloc(BlocDocument *bloc)
+{
+    free(bloc->texte);
+    libererFlot(&bloc->flot);
+    free(bloc->reprise);
+    free(bloc);
+}
+
+// Reprise du bloc : la pile quand son premier jeton devient courant
+void sauverReprise(BlocDocument *bloc, const ParseStack *stack)
+{
+    if (stack->top > PROFONDEUR_REPRISE_MAX)
+    {
+        free(bloc->reprise);
+        bloc->reprise = NULL;
+        return;
+    }
+    bloc->reprise = realloc(bloc->reprise, stack->top);
+    memcpy(bloc->reprise, stack->elements, stack->top);
+    bloc->profondeur = (uint32_t)stack->top;
+}
+
+// Analyse depuis la reprise du bloc depart (seul le premier bloc peut partir sans
+// reprise : la pile initiale). Les blocs [depart, finNouveaux) reçoivent une
+// nouvelle reprise ; au-delà, un bloc jusqu'à horizon dont la reprise est la pile
+// courante resynchronise l'analyse et le résultat précédent reste valable.
+void analyserDocument(Document *doc, size_t depart, size_t finNouveaux, size_t horizon)
+{
+    ParseStack *stack = &doc->stack;
+    BlocDocument *bloc = doc->blocs[depart];
+    if (bloc->reprise == NULL)
+    {
+        initStack(stack);
+        sauverReprise(bloc, stack);
+    }
+    else
+    {
+        stack->top = 0;
+        reserverPile(stack, bloc->profondeur);
+        memcpy(stack->elements, bloc->reprise, bloc->profondeur);
+        stack->top = bloc->profondeur;
+    }
+
+    for (size_t i = depart;; i++)
+    {
+        bloc = doc->blocs[i];
+        if (i > depart)
+        {
+            if (i >= finNouveaux && i <= horizon && bloc->reprise != NULL && bloc->profondeur == stack->top &&
+                memcmp(bloc->reprise, stack->elements, stack->top) == 0)
+                return;
+            sauverReprise(bloc, stack);
+        }
+        size_t k = 0;
+        size_t arret = i + 1 < doc->nbBlocs ? bloc->flot.nb : SIZE_MAX;
+        ResultatAnalyse resultat = poursuivreLL1(&bloc->flot, stack, NULL, &k, &doc->attendu, arret);
+        if (resultat != ANALYSE_SUSPENDUE)
+        {
+            doc->resultat = resultat;
+            doc->blocFin = i;
+            doc->jetonFin = k;
+            return;
+        }
+    }
+}
+
+// texte[longueur] doit valoir '\0'
+void ouvrirDocument(Document *doc, CSRmatrice *matrice, const char *texte, int64_t longueur)
+{
+    memset(doc, 0, sizeof(Document));
+    doc->matrice = matrice;
+    doc->longueur = longueur;
+    initialiserTS(&doc->table);
+    creerPile(&doc->stack, profondeurPileMax);
+
+    FlotJetons jetons;
+    initialiserFlot(&jetons);
+    Source src;
+    sourceDepuisTampon(&src, texte, longueur);
+    tokenize(matrice, &src, &doc->table, &jetons, NULL);
+    doc->nbJetons = jetons.nb;
+    doc->nbBlocs = jetons.nb > 0 ? (jetons.nb + JETONS_PAR_BLOC - 1) / JETONS_PAR_BLOC : 1;
+    doc->blocs = malloc(doc->nbBlocs * sizeof(BlocDocument *));
+    decouperBlocs(&jetons, texte, 0, longueur, doc->nbBlocs, doc->blocs);
+    libererFlot(&jetons);
+    indexerBlocs(doc);
+    analyserDocument(doc, 0, doc->nbBlocs, 0);
+}
+
+void fermerDocument(Document *doc)
+{
+    for (size_t i = 0; i < doc->nbBlocs; i++)
+        libererBloc(doc->blocs[i]);
+    free(doc->blocs);
+    free(doc->octets);
+    free(doc->jetons);
+    libererTS(&doc->table);
+    libererPile(&doc->stack);
+}
+
+// Appel de l'ancien flot qui part de cible ? Si oui, *bloc et *jeton désignent le
+// premier jeton qu'il produit (*jeton vaut le nombre de jetons du bloc pour l'appel
+// qui suit le dernier jeton du document).
+bool appelDocument(const Document *doc, int64_t cible, size_t *bloc, size_t *jeton)
+{
+    if (cible >= doc->longueur)
+        return false;
+    size_t i = blocDocument(doc, cible);
+    int64_t relatif = cible - origineBloc(doc, i);
+    const FlotJetons *flot = &doc->blocs[i]->flot;
+    size_t k = 0;
+    if (relatif > 0)
+    {
+        size_t haut = flot->nb;
+        while (k < haut)
+        {
+            size_t milieu = (k + haut) / 2;
+            if (finJeton(flot, milieu) < relatif)
+                k = milieu + 1;
+            else
+                haut = milieu;
+        }
+        if (k == flot->nb || finJeton(flot, k) != relatif)
+            return false;
+        k++;
+    }
+    *bloc = i;
+    *jeton = k;
+    return true;
+}
+
+// Texte du document après modification, lu sans être recopié : l'ancien texte
+// jusqu'à offset, l'insertion, puis l'ancien texte depuis offset + supprime
+typedef struct
+{
+    const Document *doc;
+    int64_t offset;
+    int64_t supprime;
+    const char *insere;
+    int64_t longueurInseree;
+} TexteModifie;
+
+ssize_t lireTexteModifie(void *contexte, int64_t position, char *destination, size_t taille)
+{
+    const TexteModifie *m = contexte;
+    size_t lus = 0;
+    while (lus < taille)
+    {
+        int64_t p = position + (int64_t)lus;
+        size_t reste = taille - lus;
+        size_t n;
+        if (p < m->offset)
+        {
+            n = (size_t)(m->offset - p) < reste ? (size_t)(m->offset - p) : reste;
+            n = lireDocument(m->doc, p, destination + lus, n);
+        }
+        else if (p < m->offset + m->longueurInseree)
+        {
+            n = (size_t)(m->offset + m->longueurInseree - p) < reste ? (size_t)(m->offset + m->longueurInseree - p)
+                                                                     : reste;
+            memcpy(destination + lus, m->insere + (p - m->offset), n);
+        }
+        else
+        {
+            n = lireDocument(m->doc, p - m->longueurInseree + m->supprime, destination + lus, reste);
+        }
+        if (n == 0)
+            break;
+        lus += n;
+    }
+    return (ssize_t)lus;
+}
+
+// Remplace supprime octets à offset par les longueurInseree octets de insere, puis
+// met à jour les blocs touchés et le résultat de l'analyse
+void modifierDocument(Document *doc, int64_t offset, int64_t supprime, const char *insere, int64_t longueurInseree)
+{
+    int64_t delta = longueurInseree - supprime;
+
+    // 1. Premier bloc à relire : celui de offset, ou le précédent si son dernier
+    // jeton finit à offset (le lexeur lit un octet au-delà de la fin du jeton)
+    size_t premier = blocDocument(doc, offset);
+    if (premier > 0 && origineBloc(doc, premier) == offset)
+        premier--;
+
+    // 2. Nouveaux jetons, lus dans le texte modifié, jusqu'à retrouver un appel de
+    // l'ancien flot
+    TexteModifie modifie = {doc, offset, supprime, insere, longueurInseree};
+    Source src;
+    ouvrirFlux(&src, -1, 4096);
+    src.lireSuite = lireTexteModifie;
+    src.contexteLecture = &modifie;
+    src.base = origineBloc(doc, premier);
+    FlotJetons nouveaux;
+    initialiserFlot(&nouveaux);
+    size_t dernier = doc->nbBlocs - 1;           // dernier ancien bloc remplacé
+    size_t garde = doc->blocs[dernier]->flot.nb; // premier jeton conservé de ce bloc
+    int64_t position = src.base;
+    bool termine = false;
+    while (!termine)
+    {
+        if (position >= offset + longueurInseree && appelDocument(doc, position - delta, &dernier, &garde))
+            break;
+        position = tokenizeDepuis(doc->matrice, &src, &doc->table, &nouveaux, position, position + 1, &termine, NULL);
+    }
+    fermerSource(&src);
+
+    // 3. Jetons des blocs [premier, dernier] : nouveaux jetons, puis jetons conservés
+    // du bloc dernier. S'il n'en reste aucun, la plage s'étend à un bloc voisin.
+    bool avant = false;
+    if (nouveaux.nb + doc->blocs[dernier]->flot.nb - garde == 0)
+    {
+        if (dernier + 1 < doc->nbBlocs)
+        {
+            dernier++;
+            garde = 0;
+        }
+        else if (premier > 0)
+        {
+            premier--;
+            avant = true;
+        }
+    }
+    int64_t origine = origineBloc(doc, premier);
+    int64_t origineDernier = origineBloc(doc, dernier);
+    int64_t fin = origineDernier + doc->blocs[dernier]->taille + delta;
+    FlotJetons jetons;
+    initialiserFlot(&jetons);
+    const FlotJetons *conserves = &doc->blocs[dernier]->flot;
+    if (avant)
+        ajouterJetons(&jetons, &doc->blocs[premier]->flot, 0, doc->blocs[premier]->flot.nb, origine);
+    ajouterJetons(&jetons, &nouveaux, 0, nouveaux.nb, 0);
+    ajouterJetons(&jetons, conserves, garde, conserves->nb - garde, origineDernier + delta);
+    libererFlot(&nouveaux);
+
+    // 4. Nouveaux blocs : autant que d'anciens, sauf s'ils sortiraient trop de la
+    // taille visée
+    size_t remplaces = dernier - premier + 1;
+    size_t nb = remplaces;
+    if (jetons.nb > nb * 2 * JETONS_PAR_BLOC || jetons.nb < nb * (JETONS_PAR_BLOC / 4))
+        nb = (jetons.nb + JETONS_PAR_BLOC - 1) / JETONS_PAR_BLOC;
+    if (nb > jetons.nb)
+        nb = jetons.nb;
+    if (nb == 0)
+        nb = 1;
+    char *texte = malloc(fin - origine + 1);
+    lireTexteModifie(&modifie, origine, texte, fin - origine);
+    BlocDocument **blocs = malloc(nb * sizeof(BlocDocument *));
+    decouperBlocs(&jetons, texte, origine, fin, nb, blocs);
+    free(texte);
+
+    // La pile devant le premier bloc ne dépend que des jetons qui le précèdent
+    blocs[0]->reprise = doc->blocs[premier]->reprise;
+    blocs[0]->profondeur = doc->blocs[premier]->profondeur;
+    doc->blocs[premier]->reprise = NULL;
+
+    // Bloc de fin de la dernière analyse, renuméroté ; s'il est remplacé, l'analyse
+    // ne peut pas se resynchroniser et le recalcule
+    size_t horizon = doc->blocFin;
+    if (horizon > dernier)
+        horizon = horizon - remplaces + nb;
+    else if (horizon >= premier)
+        horizon = premier;
+    doc->blocFin = horizon;
+
+    // 5. Remplacement des blocs : les arbres ne sont reconstruits que si leur
+    // nombre change
+    size_t retires = 0;
+    for (size_t i = premier; i <= dernier; i++)
+        retires += doc->blocs[i]->flot.nb;
+    if (nb == remplaces)
+    {
+        for (size_t i = 0; i < nb; i++)
+        {
+            BlocDocument *ancien = doc->blocs[premier + i];
+            ajouterFenwick(doc->octets, doc->nbBlocs, premier + i, blocs[i]->taille - ancien->taille);
+            ajouterFenwick(doc->jetons, doc->nbBlocs, premier + i, (int64_t)blocs[i]->flot.nb - (int64_t)ancien->flot.nb);
+            libererBloc(ancien);
+            doc->blocs[premier + i] = blocs[i];
+        }
+    }
+    else
+    {
+        for (size_t i = premier; i <= dernier; i++)
+            libererBloc(doc->blocs[i]);
+        size_t nbBlocs = doc->nbBlocs - remplaces + nb;
+        if (nb > remplaces)
+            doc->blocs = realloc(doc->blocs, nbBlocs * sizeof(BlocDocument *));
+        memmove(doc->blocs + premier + nb, doc->blocs + dernier + 1,
+                (doc->nbBlocs - dernier - 1) * sizeof(BlocDocument *));
+        memcpy(doc->blocs + premier, blocs, nb * sizeof(BlocDocument *));
+        doc->nbBlocs = nbBlocs;
+        indexerBlocs(doc);
+    }
+    free(blocs);
+    doc->longueur += delta;
+    doc->nbJetons = doc->nbJetons - retires + jetons.nb;
+    libererFlot(&jetons);
+
+    // 6. Analyse depuis la dernière reprise valable avant les nouveaux blocs
+    size_t depart = premier;
+    while (depart > 0 && (depart > horizon || doc->blocs[depart]->reprise == NULL))
+        depart--;
+    analyserDocument(doc, depart, premier + nb, horizon);
+}
+
+// --- EVALUATION PAR LOTS ---
+// Un arbre est traduit en un petit code à pile, exécuté sur des colonnes de
+// valeurs (une par identificateur, indexées par identifiant de symbole) : chaque
+// instruction traite TAILLE_LOT lignes d'un coup, dans des boucles vectorisables.
+// L'arithmétique est sur 64 bits modulo 2^64 ; division, modulo et comparaisons
+// sont signés, une comparaison vaut 0 ou 1. Une affectation vaut sa partie droite
+// (les colonnes ne sont pas modifiées).
+#define TAILLE_LOT 256
+
+// Les opérateurs suivent l'ordre de TypeNoeud à partir de NOEUD_PLUS
+typedef enum
+{
+    OP_VARIABLE,  // empile la colonne du symbole
+    OP_CONSTANTE, // empile une constante
+    OP_PLUS,
+    OP_MULT,
+    OP_MOINS,
+    OP_DIV,
+    OP_MOD,
+    OP_INF,
+    OP_INF_EGAL,
+    OP_SUP,
+    OP_SUP_EGAL,
+    OP_EGAL,
+    OP_AFFECTATION
+} CodeOp;
+
+// Division et modulo sans piège : par zéro, le résultat est 0 ; INT64_MIN / -1
+// déborde comme les autres opérations (modulo 2^64)
+uint64_t diviser(uint64_t a, uint64_t b)
+{
+    if (b == 0)
+        return 0;
+    if ((int64_t)b == -1)
+        return 0 - a;
+    return (uint64_t)((int64_t)a / (int64_t)b);
+}
+
+uint64_t modulo(uint64_t a, uint64_t b)
+{
+    if (b == 0 || (int64_t)b == -1)
+        return 0;
+    return (uint64_t)((int64_t)a % (int64_t)b);
+}
+
+// Applique un opérateur binaire (OP_PLUS à OP_AFFECTATION)
+uint64_t appliquerOperateur(CodeOp op, uint64_t a, uint64_t b)
+{
+    switch (op)
+    {
+    case OP_PLUS:
+        return a + b;
+    case OP_MULT:
+        return a * b;
+    case OP_MOINS:
+        return a - b;
+    case OP_DIV:
+        return diviser(a, b);
+    case OP_MOD:
+        return modulo(a, b);
+    case OP_INF:
+        return (int64_t)a < (int64_t)b;
+    case OP_INF_EGAL:
+        return (int64_t)a <= (int64_t)b;
+    case OP_SUP:
+        return (int64_t)a > (int64_t)b;
+    case OP_SUP_EGAL:
+        return (int64_t)a >= (int64_t)b;
+    case OP_EGAL:
+        return a == b;
+    default: // OP_AFFECTATION
+        return b;
+    }
+}
+
+typedef struct
+{
+    uint8_t op;
+    int32_t symbole;
+    int64_t constante;
+} Instruction;
+
+typedef struct
+{
+    Instruction *instructions;
+    uint32_t nb;
+    uint32_t profondeur; // hauteur maximale de la pile d'évaluation
+} Programme;
+
+// Les noeuds sont alloués quand ils sont complets : l'arène est déjà en ordre
+// postfixe et la traduction est un simple parcours
+void compilerArbre(ArbreSyntaxe *arbre, TS *table, Programme *prog)
+{
+    prog->instructions = malloc((arbre->nb ? arbre->nb : 1) * sizeof(Instruction));
+    prog->nb = 0;
+    prog->profondeur = 0;
+    uint32_t hauteur = 0;
+
+    for (uint32_t n = 0; n < arbre->nb; n++)
+    {
+        const Noeud *noeud = &arbre->noeuds[n];
+        Instruction *ins = &prog->instructions[prog->nb++];
+        ins->symbole = -1;
+        ins->constante = 0;
+        if (noeud->type == NOEUD_FEUILLE)
+        {
+            if (table->entries[noeud->gauche].type == NOMBRE)
+            {
+                ins->op = OP_CONSTANTE;
+                ins->constante = table->entries[noeud->gauche].valeur;
+            }
+            else
+            {
+                ins->op = OP_VARIABLE;
+                ins->symbole = (int32_t)noeud->gauche;
+            }
+            if (++hauteur > prog->profondeur)
+                prog->profondeur = hauteur;
+        }
+        else
+        {
+            ins->op = OP_PLUS + (noeud->type - NOEUD_PLUS);
+            hauteur--;
+        }
+    }
+}
+
+void libererProgramme(Programme *prog)
+{
+    free(prog->instructions);
+    prog->instructions = NULL;
+    prog->nb = 0;
+}
+
+// resultat[i] = valeur de l'expression pour la ligne i ; colonnes[id] est la
+// colonne de l'identificateur id (nbLignes valeurs)
+void evaluerLot(const Programme *prog, const int64_t *const *colonnes, int64_t *resultat, size_t nbLignes)
+{
+    uint64_t(*pile)[TAILLE_LOT] = malloc((prog->profondeur ? prog->profondeur : 1) * sizeof(*pile));
+
+    for (size_t debut = 0; debut < nbLignes; debut += TAILLE_LOT)
+    {
+        size_t n = nbLignes - debut < TAILLE_LOT ? nbLignes - debut : TAILLE_LOT;
+        uint32_t sommet = 0;
+
+        for (uint32_t k = 0; k < prog->nb; k++)
+        {
+            const Instruction *ins = &prog->instructions[k];
+            switch (ins->op)
+            {
+            case OP_VARIABLE:
+                memcpy(pile[sommet++], colonnes[ins->symbole] + debut, n * sizeof(int64_t));
+                break;
+            case OP_CONSTANTE:
+            {
+                uint64_t *dst = pile[sommet++];
+                for (size_t i = 0; i < n; i++)
+                    dst[i] = (uint64_t)ins->constante;
+                break;
+            }
+            case OP_PLUS:
+            {
+                uint64_t *restrict a = pile[sommet - 2];
+                const uint64_t *restrict b = pile[sommet - 1];
+                for (size_t i = 0; i < n; i++)
+                    a[i] += b[i];
+                sommet--;
+                break;
+            }
+            case OP_MULT:
+            {
+                uint64_t *restrict a = pile[sommet - 2];
+                const uint64_t *restrict b = pile[sommet - 1];
+                for (size_t i = 0; i < n; i++)
+                    a[i] *= b[i];
+                sommet--;
+                break;
+            }
+            case OP_MOINS:
+            {
+                uint64_t *restrict a = pile[sommet - 2];
+                const uint64_t *restrict b = pile[sommet - 1];
+                for (size_t i = 0; i < n; i++)
+                    a[i] -= b[i];
+                sommet--;
+                break;
+            }
+            default:
+            {
+                uint64_t *restrict a = pile[sommet - 2];
+                const uint64_t *restrict b = pile[sommet - 1];
+                for (size_t i = 0; i < n; i++)
+                    a[i] = appliquerOperateur(ins->op, a[i], b[i]);
+                sommet--;
+                break;
+            }
+            }
+        }
+        memcpy(resultat + debut, pile[0], n * sizeof(int64_t));
+    }
+    free(pile);
+}
+
+// Évaluation de référence : parcours de l'arbre pour une seule ligne
+uint64_t evaluerNoeud(ArbreSyntaxe *arbre, uint32_t n, TS *table, const int64_t *const *colonnes, size_t ligne)
+{
+    const Noeud *noeud = &arbre->noeuds[n];
+    if (noeud->type == NOEUD_FEUILLE)
+    {
+        if (table->entries[noeud->gauche].type == NOMBRE)
+            return (uint64_t)table->entries[noeud->gauche].valeur;
+        return (uint64_t)colonnes[noeud->gauche][ligne];
+    }
+    uint64_t gauche = evaluerNoeud(arbre, noeud->gauche, table, colonnes, ligne);
+    uint64_t droite = evaluerNoeud(arbre, noeud->droite, table, colonnes, ligne);
+    return appliquerOperateur(OP_PLUS + (noeud->type - NOEUD_PLUS), gauche, droite);
+}
+
+// Interpréteur ligne à ligne du programme : variables[id] est la valeur de
+// l'identificateur id (repli de executerJIT hors x86-64)
+int64_t interpreterProgramme(const Programme *prog, const int64_t *variables)
+{
+    uint64_t pileLocale[64];
+    uint64_t *pile = prog->profondeur <= 64 ? pileLocale : malloc(prog->profondeur * sizeof(uint64_t));
+    uint32_t sommet = 0;
+    pile[0] = 0;
+    for (uint32_t k = 0; k < prog->nb; k++)
+    {
+        const Instruction *ins = &prog->instructions[k];
+        if (ins->op == OP_VARIABLE)
+            pile[sommet++] = (uint64_t)variables[ins->symbole];
+        else if (ins->op == OP_CONSTANTE)
+            pile[sommet++] = (uint64_t)ins->constante;
+        else
+        {
+            sommet--;
+            pile[sommet - 1] = appliquerOperateur(ins->op, pile[sommet - 1], pile[sommet]);
+        }
+    }
+    int64_t resultat = (int64_t)pile[0];
+    if (pile != pileLocale)
+        free(pile);
+    return resultat;
+}
+
+// --- COMPILATION EN CODE MACHINE (x86-64) ---
+// Le programme est traduit en une fonction int64_t f(const int64_t *variables)
+// (convention System V : variables dans rdi, résultat dans rax), écrite dans une
+// zone mmap rendue exécutable (et non inscriptible) une fois le code complet.
+// La case k de la pile d'évaluation vit dans un registre pour k < NB_REGISTRES_JIT,
+// au-delà dans la pile machine ; chaque opérateur charge ses opérandes dans rax et
+// rcx et range le résultat dans la case du gauche. rdx est réservé à idiv.
+// Ailleurs qu'en x86-64, compilerJIT échoue et executerJIT interprète.
+typedef int64_t (*FonctionJIT)(const int64_t *variables);
+
+typedef struct
+{
+    uint8_t *code; // NULL : pas de code machine, executerJIT interprète
+    size_t taille; // octets de la zone mmap
+    FonctionJIT fonction;
+    const Programme *prog;
+} CodeJIT;
+
+#if defined(__x86_64__)
+#define NB_REGISTRES_JIT 5
+static const uint8_t registresJIT[NB_REGISTRES_JIT] = {6, 8, 9, 10, 11}; // rsi, r8 à r11
+#define RAX 0
+#define RCX 1
+
+typedef struct
+{
+    uint8_t *octets;
+    size_t nb;
+} TamponCode;
+
+void emettre(TamponCode *t, int n, ...)
+{
+    va_list args;
+    va_start(args, n);
+    for (int i = 0; i < n; i++)
+        t->octets[t->nb++] = (uint8_t)va_arg(args, int);
+    va_end(args);
+}
+
+void emettre32(TamponCode *t, uint32_t v)
+{
+    memcpy(t->octets + t->nb, &v, 4);
+    t->nb += 4;
+}
+
+// Déplacement de la case k (dans la zone réservée sous rsp)
+uint32_t deplacementCase(uint32_t k)
+{
+    return (k - NB_REGISTRES_JIT) * 8;
+}
+
+// mov reg, case k (reg : RAX ou RCX)
+void chargerCase(TamponCode *t, int reg, uint32_t k)
+{
+    if (k < NB_REGISTRES_JIT)
+    {
+        int r = registresJIT[k];
+        emettre(t, 3, 0x48 | (r >= 8 ? 1 : 0), 0x8B, 0xC0 | reg << 3 | (r & 7));
+    }
+    else
+    {
+        emettre(t, 4, 0x48, 0x8B, 0x84 | reg << 3, 0x24); // [rsp + disp32]
+        emettre32(t, deplacementCase(k));
+    }
+}
+
+// mov case k, rax
+void rangerCase(TamponCode *t, uint32_t k)
+{
+    if (k < NB_REGISTRES_JIT)
+    {
+        int r = registresJIT[k];
+        emettre(t, 3, 0x48 | (r >= 8 ? 1 : 0), 0x89, 0xC0 | (r & 7));
+    }
+    else
+    {
+        emettre(t, 4, 0x48, 0x89, 0x84, 0x24);
+        emettre32(t, deplacementCase(k));
+    }
+}
+
+// Saut court dont la cible sera fixée par fixerSaut ; renvoie la position du rel8
+size_t sautCourt(TamponCode *t, uint8_t opcode)
+{
+    emettre(t, 2, opcode, 0);
+    return t->nb - 1;
+}
+
+void fixerSaut(TamponCode *t, size_t position)
+{
+    t->octets[position] = (uint8_t)(t->nb - (position + 1));
+}
+
+// rax = rax / rcx ou rax % rcx avec la sémantique de diviser et modulo
+void emettreDivision(TamponCode *t, bool reste)
+{
+    emettre(t, 3, 0x48, 0x85, 0xC9);            // test rcx, rcx
+    size_t versZero = sautCourt(t, 0x74);       // je zero
+    emettre(t, 4, 0x48, 0x83, 0xF9, 0xFF);      // cmp rcx, -1
+    size_t versMoinsUn = sautCourt(t, 0x74);    // je moinsUn
+    emettre(t, 2, 0x48, 0x99);                  // cqo
+    emettre(t, 3, 0x48, 0xF7, 0xF9);            // idiv rcx
+    if (reste)
+        emettre(t, 3, 0x48, 0x89, 0xD0);        // mov rax, rdx
+    size_t finDivision = sautCourt(t, 0xEB);
+    fixerSaut(t, versMoinsUn);
+    if (reste)
+        emettre(t, 2, 0x31, 0xC0);              // xor eax, eax
+    else
+        emettre(t, 3, 0x48, 0xF7, 0xD8);        // neg rax
+    size_t finMoinsUn = sautCourt(t, 0xEB);
+    fixerSaut(t, versZero);
+    emettre(t, 2, 0x31, 0xC0);                  // xor eax, eax
+    fixerSaut(t, finDivision);
+    fixerSaut(t, finMoinsUn);
+}
+
+bool compilerJIT(const Programme *prog, CodeJIT *jit)
+{
+    jit->prog = prog;
+    jit->code = NULL;
+    jit->fonction = NULL;
+    // Au plus 64 octets par instruction (division entre cases en mémoire), plus
+    // prologue et épilogue
+    size_t taille = ((size_t)prog->nb * 64 + 64 + 4095) & ~(size_t)4095;
+    uint8_t *zone = mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (zone == MAP_FAILED)
+    {
+        printf("Erreur: mmap du code machine impossible\n");
+        return false;
+    }
+    TamponCode t = {zone, 0};
+
+    uint32_t cadre = 0;
+    if (prog->profondeur > NB_REGISTRES_JIT)
+    {
+        cadre = (prog->profondeur - NB_REGISTRES_JIT) * 8;
+        emettre(&t, 3, 0x48, 0x81, 0xEC); // sub rsp, imm32
+        emettre32(&t, cadre);
+    }
+
+    uint32_t sommet = 0;
+    for (uint32_t k = 0; k < prog->nb; k++)
+    {
+        const Instruction *ins = &prog->instructions[k];
+        if (ins->op == OP_VARIABLE)
+        {
+            emettre(&t, 3, 0x48, 0x8B, 0x87); // mov rax, [rdi + disp32]
+            emettre32(&t, (uint32_t)ins->symbole * 8);
+            rangerCase(&t, sommet++);
+            continue;
+        }
+        if (ins->op == OP_CONSTANTE)
+        {
+            emettre(&t, 2, 0x48, 0xB8); // mov rax, imm64
+            memcpy(t.octets + t.nb, &ins->constante, 8);
+            t.nb += 8;
+            rangerCase(&t, sommet++);
+            continue;
+        }
+
+        sommet--;
+        chargerCase(&t, RAX, sommet - 1);
+        chargerCase(&t, RCX, sommet);
+        switch (ins->op)
+        {
+        case OP_PLUS:
+            emettre(&t, 3, 0x48, 0x01, 0xC8); // add rax, rcx
+            break;
+        case OP_MOINS:
+            emettre(&t, 3, 0x48, 0x29, 0xC8); // sub rax, rcx
+            break;
+        case OP_MULT:
+            emettre(&t, 4, 0x48, 0x0F, 0xAF, 0xC1); // imul rax, rcx
+            break;
+        case OP_DIV:
+        case OP_MOD:
+            emettreDivision(&t, ins->op == OP_MOD);
+            break;
+        case OP_AFFECTATION:
+            emettre(&t, 3, 0x48, 0x89, 0xC8); // mov rax, rcx
+            break;
+        default:
+        {
+            // cmp rax, rcx ; setcc al ; movzx eax, al
+            static const uint8_t setcc[] = {[OP_INF] = 0x9C, [OP_INF_EGAL] = 0x9E, [OP_SUP] = 0x9F,
+                                            [OP_SUP_EGAL] = 0x9D, [OP_EGAL] = 0x94};
+            emettre(&t, 3, 0x48, 0x39, 0xC8);
+            emettre(&t, 3, 0x0F, setcc[ins->op], 0xC0);
+            emettre(&t, 3, 0x0F, 0xB6, 0xC0);
+            break;
+        }
+        }
+        rangerCase(&t, sommet - 1);
+    }
+
+    chargerCase(&t, RAX, 0);
+    if (cadre > 0)
+    {
+        emettre(&t, 3, 0x48, 0x81, 0xC4); // add rsp, imm32
+        emettre32(&t, cadre);
+    }
+    emettre(&t, 1, 0xC3); // ret
+
+    if (mprotect(zone, taille, PROT_READ | PROT_EXEC) != 0)
+    {
+        printf("Erreur: mprotect du code machine impossible\n");
+        munmap(zone, taille);
+        return false;
+    }
+    jit->code = zone;
+    jit->taille = taille;
+    jit->fonction = (FonctionJIT)(void *)zone;
+    return true;
+}
+#else
+bool compilerJIT(const Programme *prog, CodeJIT *jit)
+{
+    jit->prog = prog;
+    jit->code = NULL;
+    jit->fonction = NULL;
+    return false;
+}
+#endif
+
+void libererJIT(CodeJIT *jit)
+{
+    if (jit->code != NULL)
+        munmap(jit->code, jit->taille);
+    jit->code = NULL;
+    jit->fonction = NULL;
+}
+
+int64_t executerJIT(const CodeJIT *jit, const int64_t *variables)
+{
+    if (jit->fonction != NULL)
+        return jit->fonction(variables);
+    return interpreterProgramme(jit->prog, variables);
+}
+
+// --- ANALYSE PAR LOTS ---
+// Une expression par ligne, analysées en parallèle. Les lignes sont groupées en
+// blocs ; chaque ouvrier reçoit une plage de blocs qu'il consomme par le bas, les
+// ouvriers sans travail en volent par le haut chez les autres. La matrice et
+// parseTable sont partagées en lecture seule ; TS, pile et flot sont propres à
+// chaque ouvrier et les TS sont fusionnées à la fin. Les traces sont ignorées.
+#define LIGNES_PAR_BLOC 256
+
+typedef struct
+{
+    uint8_t resultat;     // ResultatAnalyse
+    uint32_t nbJetons;
+    uint32_t jetonErreur; // indice du jeton fautif si resultat != ANALYSE_REUSSIE
+    char *diagnostics;    // diagnostics du lexeur terminés par '\0', NULL si aucun
+} ResultatLigne;
+
+struct Lot;
+
+typedef struct
+{
+    _Atomic uint64_t blocs; // plage [debut, fin) restante : debut << 32 | fin
+    struct Lot *lot;
+    int numero;
+    pthread_t thread;
+    TS table;
+} Ouvrier;
+
+typedef struct Lot
+{
+    CSRmatrice *matrice;
+    const char *texte;
+    const int64_t *lignes; // début de chaque ligne, lignes[nbLignes] = fin du texte
+    size_t nbLignes;
+    ResultatLigne *resultats;
+    Ouvrier *ouvriers;
+    int nbOuvriers;
+} Lot;
+
+// Prend le bloc du bas de sa propre plage ; -1 si elle est vide
+int64_t prendreBloc(Ouvrier *ouvrier)
+{
+    uint64_t v = atomic_load(&ouvrier->blocs);
+    while ((uint32_t)(v >> 32) < (uint32_t)v)
+    {
+        if (atomic_compare_exchange_weak(&ouvrier->blocs, &v, v + (1ull << 32)))
+            return (int64_t)(v >> 32);
+    }
+    return -1;
+}
+
+// Vole le bloc du haut de la plage d'un autre ouvrier ; -1 si elle est vide
+int64_t volerBloc(Ouvrier *victime)
+{
+    uint64_t v = atomic_load(&victime->blocs);
+    while ((uint32_t)(v >> 32) < (uint32_t)v)
+    {
+        if (atomic_compare_exchange_weak(&victime->blocs, &v, v - 1))
+            return (int64_t)(uint32_t)(v - 1);
+    }
+    return -1;
+}
+
+void *executerOuvrier(void *arg)
+{
+    Ouvrier *ouvrier = arg;
+    Lot *lot = ouvrier->lot;
+    ParseStack stack;
+    creerPile(&stack, profondeurPileMax);
+    FlotJetons flot;
+    initialiserFlot(&flot);
+    // Copie de la ligne terminée par '\0' (le lexeur s'arrête sur le caractère nul)
+    size_t capacite = 256;
+    char *ligne = malloc(capacite);
+    TamponOctets diagnostics = {NULL, 0, 0};
+
+    int victime = ouvrier->numero;
+    while (1)
+    {
+        int64_t bloc = prendreBloc(ouvrier);
+        for (int essais = 0; bloc < 0 && essais < lot->nbOuvriers; essais++)
+        {
+            victime = (victime + 1) % lot->nbOuvriers;
+            bloc = volerBloc(&lot->ouvriers[victime]);
+        }
+        if (bloc < 0)
+            break;
+
+        size_t premiere = (size_t)bloc * LIGNES_PAR_BLOC;
+        size_t derniere = premiere + LIGNES_PAR_BLOC < lot->nbLignes ? premiere + LIGNES_PAR_BLOC : lot->nbLignes;
+        for (size_t l = premiere; l < derniere; l++)
+        {
+            size_t longueur = lot->lignes[l + 1] - lot->lignes[l];
+            if (longueur + 1 > capacite)
+            {
+                while (longueur + 1 > capacite)
+                    capacite *= 2;
+                ligne = realloc(ligne, capacite);
+            }
+            memcpy(ligne, lot->texte + lot->lignes[l], longueur);
+            ligne[longueur] = '\0';
+
+            Source src;
+            sourceDepuisChaine(&src, ligne);
+            flot.nb = 0;
+            diagnostics.taille = 0;
+            tokenize(lot->matrice, &src, &ouvrier->table, &flot, &diagnostics);
+            size_t k;
+            StackElement x;
+            ResultatLigne *r = &lot->resultats[l];
+            r->resultat = (uint8_t)moteurAnalyse(&flot, &stack, NULL, &k, &x);
+            r->nbJetons = (uint32_t)flot.nb;
+            r->jetonErreur = (uint32_t)k;
+            r->diagnostics = NULL;
+            if (diagnostics.taille > 0)
+            {
+                r->diagnostics = malloc(diagnostics.taille + 1);
+                memcpy(r->diagnostics, diagnostics.donnees, diagnostics.taille);
+                r->diagnostics[diagnostics.taille] = '\0';
+            }
+        }
+    }
+
+    free(diagnostics.donnees);
+    free(ligne);
+    libererFlot(&flot);
+    libererPile(&stack);
+    return NULL;
+}
+
+// Analyse les lignes de texte (longueur octets) avec nbOuvriers threads ; les
+// résultats sont rangés dans l'ordre des lignes et les symboles ajoutés à table
+ResultatLigne *analyserLot(CSRmatrice *matrice, const char *texte, int64_t longueur, int nbOuvriers, TS *table,
+                           size_t *nbLignes)
+{
+    Lot lot;
+    lot.matrice = matrice;
+    lot.texte = texte;
+
+    // Découpage en lignes (un '\n' final ne crée pas de ligne vide)
+    size_t capacite = 1024;
+    int64_t *lignes = malloc(capacite * sizeof(int64_t));
+    size_t nb = 0;
+    int64_t pos = 0;
+    while (pos < longueur)
+    {
+        if (nb + 2 > capacite)
+        {
+            capacite *= 2;
+            lignes = realloc(lignes, capacite * sizeof(int64_t));
+        }
+        lignes[nb++] = pos;
+        const char *fin = memchr(texte + pos, '\n', longueur - pos);
+        pos = fin != NULL ? fin - texte + 1 : longueur;
+    }
+    lignes[nb] = longueur;
+    lot.lignes = lignes;
+    lot.nbLignes = nb;
+    lot.resultats = malloc((nb ? nb : 1) * sizeof(ResultatLigne));
+
+    uint64_t nbBlocs = (nb + LIGNES_PAR_BLOC - 1) / LIGNES_PAR_BLOC;
+    lot.nbOuvriers = nbOuvriers;
+    lot.ouvriers = malloc(nbOuvriers * sizeof(Ouvrier));
+    for (int w = 0; w < nbOuvriers; w++)
+    {
+        Ouvrier *ouvrier = &lot.ouvriers[w];
+        uint64_t debut = nbBlocs * w / nbOuvriers;
+        uint64_t fin = nbBlocs * (w + 1) / nbOuvriers;
+        atomic_init(&ouvrier->blocs, debut << 32 | fin);
+        ouvrier->lot = &lot;
+        ouvrier->numero = w;
+        initialiserTS(&ouvrier->table);
+    }
+    for (int w = 1; w < nbOuvriers; w++)
+        pthread_create(&lot.ouvriers[w].thread, NULL, executerOuvrier, &lot.ouvriers[w]);
+    executerOuvrier(&lot.ouvriers[0]);
+    for (int w = 1; w < nbOuvriers; w++)
+        pthread_join(lot.ouvriers[w].thread, NULL);
+
+    // Fusion des tables des ouvriers
+    for (int w = 0; w < nbOuvriers; w++)
+    {
+        TS *locale = &lot.ouvriers[w].table;
+        for (int id = 0; id < locale->size; id++)
+            ajoutSymbole(table, lexemeSymbole(locale, id), locale->entries[id].longueur, locale->entries[id].type);
+        libererTS(locale);
+    }
+    free(lot.ouvriers);
+    free(lignes);
+    *nbLignes = nb;
+    return lot.resultats;
+}
+
+void libererResultats(ResultatLigne *resultats, size_t nb)
+{
+    for (size_t i = 0; i < nb; i++)
+        free(resultats[i].diagnostics);
+    free(resultats);
+}
+
+// Lit tout un descripteur en mémoire (terminé par '\0')
+char *lireTout(int fd, int64_t *longueur)
+{
+    size_t capacite = TAILLE_FENETRE;
+    char *texte = malloc(capacite + 1);
+    *longueur = 0;
+    ssize_t lus;
+    while ((lus = read(fd, texte + *longueur, capacite - *longueur)) > 0)
+    {
+        *longueur += lus;
+        if ((size_t)*longueur == capacite)
+        {
+            capacite *= 2;
+            texte = realloc(texte, capacite + 1);
+        }
+    }
+    texte[*longueur] = '\0';
+    return texte;
+}
+
+// --- COMPILATION DE PLUSIEURS FICHIERS (CACHE) ---
+// Chaque fichier est analysé avec sa propre TS ; son résultat (flot de jetons,
+// symboles locaux, statut, diagnostics) est rangé dans le répertoire de cache sous
+// l'empreinte de son contenu et de la configuration de l'analyse (moteur,
+// profondeur de pile). Quand l'empreinte est déjà connue, le lexeur et l'analyseur
+// ne sont pas relancés. Les symboles locaux sont ensuite ajoutés à la TS commune
+// et le flot renuméroté, comme dans raccorderFlot.
+// Éviction LRU : un succès remet à jour la date de modification de l'entrée et,
+// en fin de passe, les entrées les plus anciennes au-delà de maxEntrees sont
+// supprimées.
+#define VERSION_CACHE 4
+#define MAX_ENTREES_CACHE 4096
+
+static const char magieCache[8] = {'M', 'C', 'C', 'A', '\r', '\n', '\032', '\n'};
+
+// Entrée du cache : en-tête puis, dans cet ordre (alignements décroissants),
+// debut, longueur et symbole des jetons, longueur des symboles, type et terminal
+// des jetons, type des symboles, textes des symboles (séparés par '\0') et
+// diagnostics
+typedef struct
+{
+    char magie[8];
+    uint32_t version;
+    uint8_t resultat; // ResultatAnalyse
+    uint8_t pratt;
+    uint16_t reserve;
+    uint64_t empreinte;
+    uint64_t longueurSource;
+    uint64_t profondeurMax;
+    uint64_t nbJetons;
+    uint64_t jetonErreur;
+    uint32_t nbSymboles;
+    uint32_t tailleDiagnostics;
+    uint64_t tailleTextes;
+    uint64_t somme; // somme de contrôle de l'entrée (somme à 0)
+} EnteteCache;
+
+typedef struct
+{
+    size_t trouves;   // résultat lu dans le cache
+    size_t manques;   // fichier analysé (entrée absente)
+    size_t invalides; // entrée présente mais rejetée (corrompue, autre version)
+    size_t evinces;
+    size_t reussis;
+} StatsCache;
+
+// Empreinte d'un contenu pour la configuration courante de l'analyse
+uint64_t empreinteSource(const char *donnees, int64_t longueur)
+{
+    uint64_t graine = (uint64_t)VERSION_CACHE << 56 ^ (uint64_t)(moteurAnalyse == analyserPratt) << 48 ^
+                      (uint64_t)profondeurPileMax;
+    return sommeControle(graine, donnees, (size_t)longueur);
+}
+
+// Taille d'une entrée d'après son en-tête (0 si les compteurs sont incohérents)
+size_t tailleEntreeCache(const EnteteCache *entete)
+{
+    if (entete->nbJetons > UINT32_MAX || entete->tailleTextes > UINT32_MAX)
+        return 0;
+    return sizeof(EnteteCache) + entete->nbJetons * (sizeof(int64_t) + sizeof(uint32_t) + sizeof(int32_t) + 2) +
+           entete->nbSymboles * (sizeof(uint32_t) + 1) + entete->tailleTextes + entete->tailleDiagnostics;
+}
+
+// Lexe et analyse src, puis sérialise le résultat dans entree
+void analyserFichier(CSRmatrice *matrice, Source *src, uint64_t empreinte, TamponOctets *entree)
+{
+    TS locale;
+    initialiserTS(&locale);
+    FlotJetons flot;
+    initialiserFlot(&flot);
+    TamponOctets diagnostics = {NULL, 0, 0};
+    tokenize(matrice, src, &locale, &flot, &diagnostics);
+    ParseStack stack;
+    creerPile(&stack, profondeurPileMax);
+    size_t k;
+    StackElement x;
+    ResultatAnalyse resultat = moteurAnalyse(&flot, &stack, NULL, &k, &x);
+
+    // Diagnostics : ceux du lexeur, puis celui de l'analyseur
+    char message[256];
+    if (resultat != ANALYSE_REUSSIE)
+    {
+        formaterErreurSyntaxe(message, sizeof(message) - 1, resultat, &flot, k, x, stack.limite, src, &locale);
+        strcat(message, "\n");
+        ajouterOctets(&diagnostics, message, strlen(message));
+    }
+
+    EnteteCache entete;
+    memset(&entete, 0, sizeof(entete));
+    memcpy(entete.magie, magieCache, sizeof(entete.magie));
+    entete.version = VERSION_CACHE;
+    entete.resultat = (uint8_t)resultat;
+    entete.pratt = moteurAnalyse == analyserPratt;
+    entete.empreinte = empreinte;
+    entete.longueurSource = (uint64_t)src->longueur;
+    entete.profondeurMax = profondeurPileMax;
+    entete.nbJetons = flot.nb;
+    entete.jetonErreur = resultat == ANALYSE_REUSSIE ? flot.nb : k;
+    entete.nbSymboles = (uint32_t)locale.size;
+    entete.tailleDiagnostics = (uint32_t)diagnostics.taille;
+    entete.tailleTextes = locale.tailleArene;
+
+    entree->taille = 0;
+    ajouterOctets(entree, &entete, sizeof(entete));
+    ajouterOctets(entree, flot.debut, flot.nb * sizeof(int64_t));
+    ajouterOctets(entree, flot.longueur, flot.nb * sizeof(uint32_t));
+    ajouterOctets(entree, flot.symbole, flot.nb * sizeof(int32_t));
+    for (int id = 0; id < locale.size; id++)
+        ajouterOctets(entree, &locale.entries[id].longueur, sizeof(uint32_t));
+    ajouterOctets(entree, flot.type, flot.nb);
+    ajouterOctets(entree, flot.terminal, flot.nb);
+    for (int id = 0; id < locale.size; id++)
+    {
+        uint8_t type = (uint8_t)locale.entries[id].type;
+        ajouterOctets(entree, &type, 1);
+    }
+    ajouterOctets(entree, locale.arene, locale.tailleArene);
+    ajouterOctets(entree, diagnostics.donnees, diagnostics.taille);
+    entete.somme = sommeControle(0, entree->donnees, entree->taille);
+    memcpy(entree->donnees, &entete, sizeof(entete));
+
+    free(diagnostics.donnees);
+    libererPile(&stack);
+    libererFlot(&flot);
+    libererTS(&locale);
+}
+
+// Vérifie qu'une entrée correspond au contenu (empreinte, longueur) et à la
+// configuration courante, qu'elle est intacte et que ses symboles sont cohérents
+bool validerEntree(TamponOctets *entree, uint64_t empreinte, int64_t longueurSource)
+{
+    EnteteCache entete;
+    if (entree->taille < sizeof(entete))
+        return false;
+    memcpy(&entete, entree->donnees, sizeof(entete));
+    if (memcmp(entete.magie, magieCache, sizeof(entete.magie)) != 0 || entete.version != VERSION_CACHE ||
+        entete.empreinte != empreinte || entete.longueurSource != (uint64_t)longueurSource ||
+        entete.pratt != (moteurAnalyse == analyserPratt) || entete.profondeurMax != profondeurPileMax ||
+        entete.resultat > ANALYSE_SUSPENDUE || tailleEntreeCache(&entete) != entree->taille)
+        return false;
+
+    uint64_t somme = entete.somme;
+    memset(entree->donnees + offsetof(EnteteCache, somme), 0, sizeof(uint64_t));
+    bool intacte = sommeControle(0, entree->donnees, entree->taille) == somme;
+    memcpy(entree->donnees + offsetof(EnteteCache, somme), &somme, sizeof(uint64_t));
+    if (!intacte)
+        return false;
+
+    size_t nb = entete.nbJetons;
+    const char *p = entree->donnees + sizeof(entete);
+    const int32_t *symboles = (const int32_t *)(p + nb * (sizeof(int64_t) + sizeof(uint32_t)));
+    const uint32_t *longueurs = (const uint32_t *)(symboles + nb);
+    const uint8_t *types = (const uint8_t *)(longueurs + entete.nbSymboles);
+    const char *textes = (const char *)(types + 2 * nb + entete.nbSymboles);
+    uint64_t position = 0;
+    for (uint32_t id = 0; id < entete.nbSymboles; id++)
+    {
+        position += (uint64_t)longueurs[id] + 1;
+        if (position > entete.tailleTextes || textes[position - 1] != '\0')
+            return false;
+    }
+    for (size_t j = 0; j < nb; j++)
+    {
+        if (types[j] == MOTCLES ? (uint32_t)symboles[j] >= NB_CASES_MOTS_CLES
+                                : symboles[j] >= (int32_t)entete.nbSymboles || symboles[j] < -1)
+            return false;
+    }
+    return position == entete.tailleTextes;
+}
+
+// Reconstruit le flot d'une entrée validée, ajoute ses symboles à table et
+// renumérote le flot ; renvoie le résultat de l'analyse
+ResultatAnalyse decoderEntree(const TamponOctets *entree, TS *table, FlotJetons *flot, size_t *jetonErreur,
+                              const char **diagnostics, size_t *tailleDiagnostics)
+{
+    EnteteCache entete;
+    memcpy(&entete, entree->donnees, sizeof(entete));
+    size_t nb = entete.nbJetons;
+    const char *p = entree->donnees + sizeof(entete);
+
+    flot->nb = 0;
+    reserverJetons(flot, nb);
+    flot->nb = nb;
+    memcpy(flot->debut, p, nb * sizeof(int64_t));
+    p += nb * sizeof(int64_t);
+    memcpy(flot->longueur, p, nb * sizeof(uint32_t));
+    p += nb * sizeof(uint32_t);
+    memcpy(flot->symbole, p, nb * sizeof(int32_t));
+    p += nb * sizeof(int32_t);
+    const uint32_t *longueurs = (const uint32_t *)p;
+    p += entete.nbSymboles * sizeof(uint32_t);
+    memcpy(flot->type, p, nb);
+    p += nb;
+    memcpy(flot->terminal, p, nb);
+    p += nb;
+    const uint8_t *typesSymboles = (const uint8_t *)p;
+    p += entete.nbSymboles;
+
+    int32_t *global = malloc((entete.nbSymboles ? entete.nbSymboles : 1) * sizeof(int32_t));
+    for (uint32_t id = 0; id < entete.nbSymboles; id++)
+    {
+        global[id] = ajoutSymbole(table, p, (int)longueurs[id], (LexemeType)typesSymboles[id]);
+        p += longueurs[id] + 1;
+    }
+    for (size_t j = 0; j < nb; j++)
+    {
+        if (flot->type[j] != MOTCLES && flot->symbole[j] >= 0)
+            flot->symbole[j] = global[flot->symbole[j]];
+    }
+    free(global);
+
+    *jetonErreur = entete.jetonErreur;
+    *diagnostics = p;
+    *tailleDiagnostics = entete.tailleDiagnostics;
+    return (ResultatAnalyse)entete.resultat;
+}
+
+// Lit l'entrée du cache dans tampon et la marque comme la plus récente
+bool lireEntreeCache(const char *chemin, TamponOctets *entree)
+{
+    int fd = open(chemin, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    bool lue = fstat(fd, &info) == 0;
+    entree->taille = 0;
+    if (lue && (size_t)info.st_size > entree->capacite)
+    {
+        entree->capacite = (size_t)info.st_size;
+        entree->donnees = realloc(entree->donnees, entree->capacite);
+    }
+    while (lue && entree->taille < (size_t)info.st_size)
+    {
+        ssize_t lus = read(fd, entree->donnees + entree->taille, (size_t)info.st_size - entree->taille);
+        lue = lus > 0;
+        entree->taille += lue ? (size_t)lus : 0;
+    }
+    if (lue)
+        futimens(fd, NULL);
+    close(fd);
+    return lue;
+}
+
+// Écrit l'entrée dans un fichier temporaire renommé à la fin (une autre
+// compilation ne lit jamais une entrée partielle)
+bool ecrireEntreeCache(const char *chemin, const TamponOctets *entree)
+{
+    size_t longueur = strlen(chemin);
+    char *temporaire = malloc(longueur + 5);
+    memcpy(temporaire, chemin, longueur);
+    memcpy(temporaire + longueur, ".tmp", 5);
+    int fd = open(temporaire, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ecrite = fd >= 0;
+    for (size_t ecrits = 0; ecrite && ecrits < entree->taille;)
+    {
+        ssize_t n = write(fd, entree->donnees + ecrits, entree->taille - ecrits);
+        ecrite = n > 0;
+        ecrits += ecrite ? (size_t)n : 0;
+    }
+    if (fd >= 0)
+        ecrite &= close(fd) == 0;
+    ecrite = ecrite && rename(temporaire, chemin) == 0;
+    if (!ecrite)
+        unlink(temporaire);
+    free(temporaire);
+    return ecrite;
+}
+
+typedef struct
+{
+    char *nom;
+    struct timespec date;
+} EntreeRepertoire;
+
+int comparerDates(const void *a, const void *b)
+{
+    const struct timespec *x = &((const EntreeRepertoire *)a)->date;
+    const struct timespec *y = &((const EntreeRepertoire *)b)->date;
+    if (x->tv_sec != y->tv_sec)
+        return x->tv_sec < y->tv_sec ? -1 : 1;
+    return (x->tv_nsec > y->tv_nsec) - (x->tv_nsec < y->tv_nsec);
+}
+
+// Supprime les entrées les moins récemment utilisées au-delà de maxEntrees ;
+// renvoie le nombre d'entrées supprimées
+size_t evincerCache(const char *repertoire, size_t maxEntrees)
+{
+    DIR *dir = opendir(repertoire);
+    if (dir == NULL)
+        return 0;
+    size_t nb = 0, capacite = 64;
+    EntreeRepertoire *entrees = malloc(capacite * sizeof(EntreeRepertoire));
+    char chemin[4096];
+    struct dirent *d;
+    while ((d = readdir(dir)) != NULL)
+    {
+        size_t longueur = strlen(d->d_name);
+        struct stat info;
+        snprintf(chemin, sizeof(chemin), "%s/%s", repertoire, d->d_name);
+        if (longueur < 6 || strcmp(d->d_name + longueur - 6, ".cache") != 0 || stat(chemin, &info) != 0)
+            continue;
+        if (nb == capacite)
+        {
+            capacite *= 2;
+            entrees = realloc(entrees, capacite * sizeof(EntreeRepertoire));
+        }
+        entrees[nb].nom = strdup(d->d_name);
+        entrees[nb].date = info.st_mtim;
+        nb++;
+    }
+    closedir(dir);
+
+    size_t evinces = 0;
+    if (nb > maxEntrees)
+    {
+        qsort(entrees, nb, sizeof(EntreeRepertoire), comparerDates);
+        for (size_t i = 0; i < nb - maxEntrees; i++)
+        {
+            snprintf(chemin, sizeof(chemin), "%s/%s", repertoire, entrees[i].nom);
+            evinces += unlink(chemin) == 0;
+        }
+    }
+    for (size_t i = 0; i < nb; i++)
+        free(entrees[i].nom);
+    free(entrees);
+    return evinces;
+}
+
+// Analyse chaque fichier, en passant par le cache si repertoire n'est pas NULL,
+// et ajoute ses symboles à table. Avec afficher, une ligne par fichier suivie
+// de ses diagnostics.
+void compilerFichiers(CSRmatrice *matrice, char **chemins, int nbFichiers, const char *repertoire,
+                      size_t maxEntrees, TS *table, bool afficher, StatsCache *stats)
+{
+    memset(stats, 0, sizeof(StatsCache));
+    if (repertoire != NULL)
+        mkdir(repertoire, 0755);
+
+    TamponOctets entree = {NULL, 0, 0};
+    FlotJetons flot;
+    initialiserFlot(&flot);
+    char chemin[4096];
+    for (int f = 0; f < nbFichiers; f++)
+    {
+        Source src;
+        if (!ouvrirFichier(&src, chemins[f]))
+            continue;
+        uint64_t empreinte = empreinteSource(src.donnees, src.longueur);
+        bool trouve = false;
+        if (repertoire != NULL)
+        {
+            snprintf(chemin, sizeof(chemin), "%s/%016" PRIx64 ".cache", repertoire, empreinte);
+            if (lireEntreeCache(chemin, &entree))
+            {
+                trouve = validerEntree(&entree, empreinte, src.longueur);
+                stats->invalides += !trouve;
+            }
+        }
+        if (trouve)
+        {
+            stats->trouves++;
+        }
+        else
+        {
+            stats->manques++;
+            analyserFichier(matrice, &src, empreinte, &entree);
+            if (repertoire != NULL)
+                ecrireEntreeCache(chemin, &entree);
+        }
+        fermerSource(&src);
+
+        size_t jetonErreur;
+        const char *diagnostics;
+        size_t tailleDiagnostics;
+        ResultatAnalyse resultat = decoderEntree(&entree, table, &flot, &jetonErreur, &diagnostics, &tailleDiagnostics);
+        stats->reussis += resultat == ANALYSE_REUSSIE;
+        if (afficher)
+        {
+            if (resultat == ANALYSE_REUSSIE)
+                printf("%s: ok, %zu jetons\n", chemins[f], flot.nb);
+            else
+                printf("%s: erreur au jeton %zu\n", chemins[f], jetonErreur + 1);
+            fwrite(diagnostics, 1, tailleDiagnostics, stdout);
+        }
+    }
+    if (repertoire != NULL)
+        stats->evinces = evincerCache(repertoire, maxEntrees);
+
+    libererFlot(&flot);
+    free(entree.donnees);
+}
+
+// --- SERVEUR DE COMPILATION ---
+// Processus résident : la matrice et la table d'analyse sont construites une fois,
+// puis les requêtes arrivent sur une socket Unix. Un thread fait tourner la boucle
+// epoll (acceptation, lecture, découpage des trames, écriture des réponses) ; un
+// groupe d'ouvriers analyse et évalue, chacun avec sa TS, sa pile, son flot et son
+// arbre, vidés entre deux requêtes. Les ouvriers rendent les connexions traitées
+// par une liste et réveillent la boucle par un eventfd. Une connexion n'a qu'une
+// requête à la fois chez les ouvriers : les réponses suivent l'ordre des requêtes.
+//
+// Protocole (entiers petit-boutistes) :
+//   requête : longueur (uint32, octets qui suivent), opération (1 octet), texte
+//   réponse : longueur (uint32), statut (StatutReponse, 1 octet), texte
+// Opérations :
+//   'A' analyser : le texte est l'expression ; réponse : l'arbre en notation
+//       préfixe, ou le diagnostic
+//   'E' évaluer : l'expression sur la première ligne, puis une ligne "nom=valeur"
+//       par identificateur ; réponse : la valeur en décimal
+//   'S' statistiques : histogrammes des latences du serveur (texte)
+// Une trame vide ou de plus de TAILLE_REQUETE_MAX octets ferme la connexion.
+#define TAILLE_REQUETE_MAX (1 << 20)
+#define NOEUDS_REPONSE_MAX 4096 // au-delà, la réponse donne le nombre de noeuds
+#define MAX_EVENEMENTS 64
+
+enum
+{
+    REQUETE_ANALYSER = 'A',
+    REQUETE_EVALUER = 'E',
+    REQUETE_STATISTIQUES = 'S'
+};
+
+typedef enum
+{
+    REPONSE_OK,
+    REPONSE_ERREUR_LEXICALE,
+    REPONSE_ERREUR_SYNTAXE,
+    REPONSE_REQUETE_INVALIDE // opération inconnue, variable sans valeur
+} StatutReponse;
+
+double maintenantNs();
+
+// Histogramme de latences (ns) : 8 intervalles par puissance de 2, soit une
+// précision relative de 12,5 % sur toute l'étendue
+#define INTERVALLES_PAR_OCTAVE 8
+#define NB_INTERVALLES_LATENCE (64 * INTERVALLES_PAR_OCTAVE)
+
+typedef struct
+{
+    uint64_t nb[NB_INTERVALLES_LATENCE];
+    uint64_t total;
+    uint64_t max;
+} HistogrammeLatences;
+
+int intervalleLatence(uint64_t ns)
+{
+    if (ns < INTERVALLES_PAR_OCTAVE)
+        return (int)ns;
+    int exposant = 63 - __builtin_clzll(ns); // au moins 3
+    return (exposant - 2) * INTERVALLES_PAR_OCTAVE + (int)((ns >> (exposant - 3)) & 7);
+}
+
+// Plus petite latence de l'intervalle i
+uint64_t debutIntervalle(int i)
+{
+    if (i < INTERVALLES_PAR_OCTAVE)
+        return (uint64_t)i;
+    int exposant = i / INTERVALLES_PAR_OCTAVE + 2;
+    return (uint64_t)(INTERVALLES_PAR_OCTAVE + i % INTERVALLES_PAR_OCTAVE) << (exposant - 3);
+}
+
+void noterLatence(HistogrammeLatences *h, uint64_t ns)
+{
+    h->nb[intervalleLatence(ns)]++;
+    h->total++;
+    if (ns > h->max)
+        h->max = ns;
+}
+
+void cumulerLatences(HistogrammeLatences *h, const HistogrammeLatences *autre)
+{
+    for (int i = 0; i < NB_INTERVALLES_LATENCE; i++)
+        h->nb[i] += autre->nb[i];
+    h->total += autre->total;
+    if (autre->max > h->max)
+        h->max = autre->max;
+}
+
+// Borne haute de l'intervalle qui contient le centile demandé (0 à 1)
+uint64_t centileLatence(const HistogrammeLatences *h, double centile)
+{
+    uint64_t rang = (uint64_t)(centile * h->total);
+    uint64_t cumul = 0;
+    for (int i = 0; i < NB_INTERVALLES_LATENCE; i++)
+    {
+        cumul += h->nb[i];
+        if (cumul > rang)
+            return i + 1 < NB_INTERVALLES_LATENCE && debutIntervalle(i + 1) - 1 < h->max ? debutIntervalle(i + 1) - 1
+                                                                                        : h->max;
+    }
+    return h->max;
+}
+
+// Résumé (nombre, centiles en µs) puis, avec intervalles, une ligne par
+// intervalle non vide : début en ns et nombre de requêtes
+void ecrireLatences(TamponOctets *sortie, const char *nom, const HistogrammeLatences *h, bool intervalles)
+{
+    char ligne[256];
+    ajouterOctets(sortie, ligne,
+                  snprintf(ligne, sizeof(ligne), "%s: %" PRIu64 " requetes, p50 %.1f us, p90 %.1f us, p99 %.1f us, "
+                           "max %.1f us\n", nom, h->total, centileLatence(h, 0.50) / 1e3,
+                           centileLatence(h, 0.90) / 1e3, centileLatence(h, 0.99) / 1e3, h->max / 1e3));
+    for (int i = 0; intervalles && i < NB_INTERVALLES_LATENCE; i++)
+    {
+        if (h->nb[i] != 0)
+            ajouterOctets(sortie, ligne,
+                          snprintf(ligne, sizeof(ligne), "  %" PRIu64 " %" PRIu64 "\n", debutIntervalle(i), h->nb[i]));
+    }
+}
+
+typedef struct Connexion
+{
+    int fd; // -1 une fois fermée
+    size_t rang; // position dans Serveur.connexions
+    TamponOctets entree;
+    size_t consomme; // octets de entree déjà découpés en trames
+    TamponOctets sortie;
+    size_t envoye;
+    bool attenteEcriture; // EPOLLOUT demandé
+    bool finEntree;       // le client n'écrit plus : fermer après la dernière réponse
+    bool enCours;         // requête chez les ouvriers
+    TamponOctets requete; // opération et texte de la requête en cours
+    TamponOctets reponse; // trame complète écrite par l'ouvrier
+    double arrivee; // trame complète (ns)
+    double prise;   // prise par un ouvrier
+    struct Connexion *suivante; // liste des connexions traitées
+} Connexion;
+
+typedef struct
+{
+    CSRmatrice *matrice;
+    const char *chemin;
+    int ecoute;
+    int epoll;
+    int reveil; // eventfd : des connexions traitées attendent la boucle
+    _Atomic bool arret;
+
+    pthread_mutex_t verrou;
+    pthread_cond_t travail;
+    Connexion **file; // requêtes en attente (tableau circulaire)
+    size_t tete, nbFile, capaciteFile;
+    Connexion *traitees;
+    bool fin; // les ouvriers s'arrêtent
+
+    pthread_t *ouvriers;
+    int nbOuvriers;
+    Connexion **connexions;
+    size_t nbConnexions, capaciteConnexions;
+
+    // Propres à la boucle : latence de la trame complète à la réponse écrite
+    HistogrammeLatences latences[2]; // analyser, évaluer
+    HistogrammeLatences attente;     // de la trame complète à la prise par un ouvrier
+    uint64_t requetes;
+    uint64_t invalides;
+} Serveur;
+
+// Reçoit le signal d'arrêt (SIGINT, SIGTERM) en mode --serveur
+volatile sig_atomic_t signalArret = 0;
+
+void noterSignalArret(int signal)
+{
+    (void)signal;
+    signalArret = 1;
+}
+
+typedef struct
+{
+    Serveur *serveur;
+    TS table;
+    ParseStack stack;
+    FlotJetons flot;
+    ArbreSyntaxe arbre;
+    char *texte; // copie de l'expression terminée par '\0'
+    size_t capaciteTexte;
+    TamponOctets diagnostics;
+    int64_t *variables;
+    bool *liees;
+    int capaciteVariables;
+} OuvrierServeur;
+
+// Vide la TS sans rendre sa mémoire (les identifiants repartent de 0)
+void viderTS(TS *table)
+{
+    for (uint32_t i = 0; i <= table->masque; i++)
+        table->cases[i].id = -1;
+    table->size = 0;
+    table->tailleArene = 0;
+}
+
+// Même notation qu'afficherNoeud, dans un tampon
+void ecrireNoeud(TamponOctets *sortie, ArbreSyntaxe *arbre, uint32_t n, TS *table)
+{
+    const Noeud *noeud = &arbre->noeuds[n];
+    if (noeud->type == NOEUD_FEUILLE)
+    {
+        ajouterOctets(sortie, lexemeSymbole(table, noeud->gauche), table->entries[noeud->gauche].longueur);
+        return;
+    }
+    ajouterOctets(sortie, "(", 1);
+    ajouterOctets(sortie, operateursNoeuds[noeud->type], strlen(operateursNoeuds[noeud->type]));
+    ajouterOctets(sortie, " ", 1);
+    ecrireNoeud(sortie, arbre, noeud->gauche, table);
+    ajouterOctets(sortie, " ", 1);
+    ecrireNoeud(sortie, arbre, noeud->droite, table);
+    ajouterOctets(sortie, ")", 1);
+}
+
+// Commence une trame de réponse ; la longueur est fixée par terminerReponse
+void commencerReponse(TamponOctets *reponse, StatutReponse statut)
+{
+    uint8_t entete[5] = {0, 0, 0, 0, (uint8_t)statut};
+    reponse->taille = 0;
+    ajouterOctets(reponse, entete, sizeof(entete));
+}
+
+void terminerReponse(TamponOctets *reponse)
+{
+    uint32_t longueur = (uint32_t)(reponse->taille - 4);
+    memcpy(reponse->donnees, &longueur, 4);
+}
+
+void repondre(TamponOctets *reponse, StatutReponse statut, const char *texte, size_t longueur)
+{
+    commencerReponse(reponse, statut);
+    ajouterOctets(reponse, texte, longueur);
+    terminerReponse(reponse);
+}
+
+// Valeurs "nom=valeur" (une par ligne) des identificateurs de la TS ; false si
+// une ligne est mal formée
+bool lireVariables(OuvrierServeur *o, const char *texte, size_t longueur)
+{
+    if (o->table.size > o->capaciteVariables)
+    {
+        o->capaciteVariables = o->table.size;
+        o->variables = realloc(o->variables, o->capaciteVariables * sizeof(int64_t));
+        o->liees = realloc(o->liees, o->capaciteVariables * sizeof(bool));
+    }
+    memset(o->liees, 0, o->table.size * sizeof(bool));
+    size_t i = 0;
+    while (i < longueur)
+    {
+        const char *ligne = texte + i;
+        const char *finLigne = memchr(ligne, '\n', longueur - i);
+        size_t taille = finLigne != NULL ? (size_t)(finLigne - ligne) : longueur - i;
+        i += taille + 1;
+        if (taille == 0)
+            continue;
+        const char *egal = memchr(ligne, '=', taille);
+        if (egal == NULL)
+            return false;
+        const char *chiffres = egal + 1;
+        size_t nbChiffres = taille - (chiffres - ligne);
+        bool negatif = nbChiffres > 0 && *chiffres == '-';
+        chiffres += negatif;
+        nbChiffres -= negatif;
+        for (size_t c = 0; c < nbChiffres; c++)
+        {
+            if (chiffres[c] < '0' || chiffres[c] > '9')
+                return false;
+        }
+        int64_t valeur;
+        if (nbChiffres == 0 || !convertirNombre(chiffres, (int)nbChiffres, &valeur))
+            return false;
+        int id = chercherSymbole(&o->table, ligne, (int)(egal - ligne));
+        if (id >= 0)
+        {
+            o->variables[id] = negatif ? (int64_t)(0 - (uint64_t)valeur) : valeur;
+            o->liees[id] = true;
+        }
+    }
+    return true;
+}
+
+// Analyse (et évalue) la requête de c->requete, écrit la trame dans c->reponse
+void traiterRequete(OuvrierServeur *o, Connexion *c)
+{
+    uint8_t operation = (uint8_t)c->requete.donnees[0];
+    const char *expression = c->requete.donnees + 1;
+    size_t longueur = c->requete.taille - 1;
+    TamponOctets *reponse = &c->reponse;
+    if (operation != REQUETE_ANALYSER && operation != REQUETE_EVALUER)
+    {
+        const char message[] = "Erreur : operation inconnue";
+        repondre(reponse, REPONSE_REQUETE_INVALIDE, message, sizeof(message) - 1);
+        return;
+    }
+    // L'expression d'une évaluation s'arrête à la fin de sa première ligne
+    const char *variables = expression + longueur;
+    if (operation == REQUETE_EVALUER)
+    {
+        const char *finLigne = memchr(expression, '\n', longueur);
+        if (finLigne != NULL)
+        {
+            variables = finLigne + 1;
+            longueur = finLigne - expression;
+        }
+    }
+    size_t longueurVariables = c->requete.donnees + c->requete.taille - variables;
+
+    if (longueur + 1 > o->capaciteTexte)
+    {
+        while (longueur + 1 > o->capaciteTexte)
+            o->capaciteTexte = o->capaciteTexte ? o->capaciteTexte * 2 : 256;
+        o->texte = realloc(o->texte, o->capaciteTexte);
+    }
+    memcpy(o->texte, expression, longueur);
+    o->texte[longueur] = '\0';
+
+    viderTS(&o->table);
+    o->flot.nb = 0;
+    Source src;
+    sourceDepuisChaine(&src, o->texte);
+    // Diagnostics du lexeur : une ligne chacun, renvoyés sans le dernier saut de ligne
+    o->diagnostics.taille = 0;
+    tokenize(o->serveur->matrice, &src, &o->table, &o->flot, &o->diagnostics);
+    char message[256];
+    if (o->diagnostics.taille > 0)
+    {
+        repondre(reponse, REPONSE_ERREUR_LEXICALE, o->diagnostics.donnees, o->diagnostics.taille - 1);
+        return;
+    }
+
+    size_t k;
+    StackElement x;
+    ResultatAnalyse resultat = moteurAnalyse(&o->flot, &o->stack, &o->arbre, &k, &x);
+    if (resultat != ANALYSE_REUSSIE)
+    {
+        formaterErreurSyntaxe(message, sizeof(message), resultat, &o->flot, k, x, o->stack.limite, &src, &o->table);
+        repondre(reponse, REPONSE_ERREUR_SYNTAXE, message, strlen(message));
+        return;
+    }
+
+    if (operation == REQUETE_ANALYSER)
+    {
+        commencerReponse(reponse, REPONSE_OK);
+        if (o->arbre.nb <= NOEUDS_REPONSE_MAX)
+            ecrireNoeud(reponse, &o->arbre, o->arbre.racine, &o->table);
+        else
+            ajouterOctets(reponse, message, snprintf(message, sizeof(message), "%u noeuds", o->arbre.nb));
+        terminerReponse(reponse);
+        return;
+    }
+
+    if (!lireVariables(o, variables, longueurVariables))
+    {
+        const char erreur[] = "Erreur : ligne de variable mal formee (nom=valeur attendu)";
+        repondre(reponse, REPONSE_REQUETE_INVALIDE, erreur, sizeof(erreur) - 1);
+        return;
+    }
+    for (int id = 0; id < o->table.size; id++)
+    {
+        if (o->table.entries[id].type == IDENTIFIER && !o->liees[id])
+        {
+            int taille = snprintf(message, sizeof(message), "Erreur : variable sans valeur - '%s'",
+                                  lexemeSymbole(&o->table, id));
+            repondre(reponse, REPONSE_REQUETE_INVALIDE, message, taille < (int)sizeof(message) ? taille : 255);
+            return;
+        }
+    }
+    Programme prog;
+    compilerArbre(&o->arbre, &o->table, &prog);
+    int64_t valeur = interpreterProgramme(&prog, o->variables);
+    libererProgramme(&prog);
+    repondre(reponse, REPONSE_OK, message, snprintf(message, sizeof(message), "%" PRId64, valeur));
+}
+
+void *executerOuvrierServeur(void *arg)
+{
+    OuvrierServeur *o = arg;
+    Serveur *s = o->serveur;
+    while (1)
+    {
+        pthread_mutex_lock(&s->verrou);
+        while (s->nbFile == 0 && !s->fin)
+            pthread_cond_wait(&s->travail, &s->verrou);
+        if (s->fin)
+        {
+            pthread_mutex_unlock(&s->verrou);
+            break;
+        }
+        Connexion *c = s->file[s->tete];
+        s->tete = (s->tete + 1) % s->capaciteFile;
+        s->nbFile--;
+        pthread_mutex_unlock(&s->verrou);
+
+        c->prise = maintenantNs();
+        traiterRequete(o, c);
+
+        pthread_mutex_lock(&s->verrou);
+        c->suivante = s->traitees;
+        s->traitees = c;
+        pthread_mutex_unlock(&s->verrou);
+        uint64_t un = 1;
+        if (write(s->reveil, &un, sizeof(un)) != sizeof(un))
+        {
+            // Compteur de l'eventfd saturé : la boucle est déjà réveillée
+        }
+    }
+    libererArbre(&o->arbre);
+    libererFlot(&o->flot);
+    libererPile(&o->stack);
+    libererTS(&o->table);
+    free(o->texte);
+    free(o->diagnostics.donnees);
+    free(o->variables);
+    free(o->liees);
+    free(o);
+    return NULL;
+}
+
+void fermerConnexion(Serveur *s, Connexion *c)
+{
+    if (c->fd >= 0)
+    {
+        close(c->fd); // retire aussi la socket de l'epoll
+        c->fd = -1;
+    }
+    if (c->enCours)
+        return; // libérée quand l'ouvrier la rend
+    s->connexions[c->rang] = s->connexions[--s->nbConnexions];
+    s->connexions[c->rang]->rang = c->rang;
+    free(c->entree.donnees);
+    free(c->sortie.donnees);
+    free(c->requete.donnees);
+    free(c->reponse.donnees);
+    free(c);
+}
+
+// Événements attendus : lecture jusqu'à la fin du flux, écriture quand la
+// réponse n'a pas pu partir d'un coup
+void surveiller(Serveur *s, Connexion *c, bool ecriture)
+{
+    struct epoll_event evenement;
+    evenement.events = (c->finEntree ? 0 : EPOLLIN) | (ecriture ? EPOLLOUT : 0);
+    evenement.data.ptr = c;
+    epoll_ctl(s->epoll, EPOLL_CTL_MOD, c->fd, &evenement);
+    c->attenteEcriture = ecriture;
+}
+
+// Écrit ce qui peut l'être sans bloquer ; false si le client est parti
+bool envoyer(Serveur *s, Connexion *c)
+{
+    while (c->envoye < c->sortie.taille)
+    {
+        ssize_t n = send(c->fd, c->sortie.donnees + c->envoye, c->sortie.taille - c->envoye, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            if (!c->attenteEcriture)
+                surveiller(s, c, true);
+            return true;
+        }
+        if (n <= 0)
+            return false;
+        c->envoye += n;
+    }
+    c->sortie.taille = 0;
+    c->envoye = 0;
+    if (c->attenteEcriture)
+        surveiller(s, c, false);
+    return true;
+}
+
+// Le client n'écrit plus et toutes ses réponses sont parties
+bool connexionTerminee(const Connexion *c)
+{
+    return c->finEntree && !c->enCours && c->sortie.taille == 0;
+}
+
+// Découpe les trames complètes de c->entree : les statistiques sont servies par
+// la boucle, le reste part chez les ouvriers (une requête à la fois). false si la
+// connexion doit être fermée.
+bool decouperTrames(Serveur *s, Connexion *c)
+{
+    while (!c->enCours && c->entree.taille - c->consomme >= 4)
+    {
+        uint32_t longueur;
+        memcpy(&longueur, c->entree.donnees + c->consomme, 4);
+        if (longueur == 0 || longueur > TAILLE_REQUETE_MAX)
+        {
+            s->invalides++;
+            return false;
+        }
+        if (c->entree.taille - c->consomme - 4 < longueur)
+            break;
+        const char *trame = c->entree.donnees + c->consomme + 4;
+        c->consomme += 4 + (size_t)longueur;
+        s->requetes++;
+
+        if (trame[0] == REQUETE_STATISTIQUES)
+        {
+            TamponOctets *r = &c->reponse;
+            commencerReponse(r, REPONSE_OK);
+            ecrireLatences(r, "analyser", &s->latences[0], true);
+            ecrireLatences(r, "evaluer", &s->latences[1], true);
+            ecrireLatences(r, "attente", &s->attente, false);
+            terminerReponse(r);
+            ajouterOctets(&c->sortie, r->donnees, r->taille);
+            if (!envoyer(s, c))
+                return false;
+            continue;
+        }
+
+        c->requete.taille = 0;
+        ajouterOctets(&c->requete, trame, longueur);
+        c->enCours = true;
+        c->arrivee = maintenantNs();
+        pthread_mutex_lock(&s->verrou);
+        if (s->nbFile == s->capaciteFile)
+        {
+            // Agrandissement du tableau circulaire : on le remet à plat
+            size_t capacite = s->capaciteFile ? s->capaciteFile * 2 : 64;
+            Connexion **file = malloc(capacite * sizeof(Connexion *));
+            for (size_t i = 0; i < s->nbFile; i++)
+                file[i] = s->file[(s->tete + i) % s->capaciteFile];
+            free(s->file);
+            s->file = file;
+            s->tete = 0;
+            s->capaciteFile = capacite;
+        }
+        s->file[(s->tete + s->nbFile) % s->capaciteFile] = c;
+        s->nbFile++;
+        pthread_cond_signal(&s->travail);
+        pthread_mutex_unlock(&s->verrou);
+    }
+    // Octets déjà découpés : on les retire du tampon
+    if (c->consomme > 0 && (c->consomme == c->entree.taille || c->consomme >= 65536))
+    {
+        memmove(c->entree.donnees, c->entree.donnees + c->consomme, c->entree.taille - c->consomme);
+        c->entree.taille -= c->consomme;
+        c->consomme = 0;
+    }
+    return true;
+}
+
+// Lit tout ce qui est disponible ; false sur erreur. En fin de flux, la lecture
+// n'est plus surveillée et les requêtes reçues sont encore servies.
+bool lireConnexion(Serveur *s, Connexion *c)
+{
+    char tampon[65536];
+    while (1)
+    {
+        ssize_t n = recv(c->fd, tampon, sizeof(tampon), 0);
+        if (n > 0)
+        {
+            ajouterOctets(&c->entree, tampon, n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n == 0)
+        {
+            c->finEntree = true;
+            surveiller(s, c, c->attenteEcriture);
+            return true;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+void accepterConnexions(Serveur *s)
+{
+    while (1)
+    {
+        int fd = accept(s->ecoute, NULL, NULL);
+        if (fd < 0)
+            return; // EAGAIN : plus de connexion en attente
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        Connexion *c = calloc(1, sizeof(Connexion));
+        c->fd = fd;
+        if (s->nbConnexions == s->capaciteConnexions)
+        {
+            s->capaciteConnexions = s->capaciteConnexions ? s->capaciteConnexions * 2 : 64;
+            s->connexions = realloc(s->connexions, s->capaciteConnexions * sizeof(Connexion *));
+        }
+        c->rang = s->nbConnexions;
+        s->connexions[s->nbConnexions++] = c;
+        struct epoll_event evenement;
+        evenement.events = EPOLLIN;
+        evenement.data.ptr = c;
+        epoll_ctl(s->epoll, EPOLL_CTL_ADD, fd, &evenement);
+    }
+}
+
+// Reprend les connexions rendues par les ouvriers
+void rendreConnexions(Serveur *s)
+{
+    uint64_t compteur;
+    if (read(s->reveil, &compteur, sizeof(compteur)) != sizeof(compteur))
+        return;
+    pthread_mutex_lock(&s->verrou);
+    Connexion *c = s->traitees;
+    s->traitees = NULL;
+    pthread_mutex_unlock(&s->verrou);
+    double maintenant = maintenantNs();
+    while (c != NULL)
+    {
+        Connexion *suivante = c->suivante;
+        c->enCours = false;
+        noterLatence(&s->attente, (uint64_t)(c->prise - c->arrivee));
+        if (c->fd < 0)
+        {
+            fermerConnexion(s, c);
+            c = suivante;
+            continue;
+        }
+        noterLatence(&s->latences[c->requete.donnees[0] == REQUETE_EVALUER], (uint64_t)(maintenant - c->arrivee));
+        ajouterOctets(&c->sortie, c->reponse.donnees, c->reponse.taille);
+        if (!envoyer(s, c) || !decouperTrames(s, c) || connexionTerminee(c))
+            fermerConnexion(s, c);
+        c = suivante;
+    }
+}
+
+bool demarrerServeur(Serveur *s, CSRmatrice *matrice, const char *chemin, int nbOuvriers)
+{
+    memset(s, 0, sizeof(Serveur));
+    s->matrice = matrice;
+    s->chemin = chemin;
+    struct sockaddr_un adresse;
+    memset(&adresse, 0, sizeof(adresse));
+    adresse.sun_family = AF_UNIX;
+    if (strlen(chemin) >= sizeof(adresse.sun_path))
+    {
+        printf("Erreur: Chemin de socket trop long '%s'\n", chemin);
+        return false;
+    }
+    strcpy(adresse.sun_path, chemin);
+    unlink(chemin); // socket laissée par un serveur précédent
+    s->ecoute = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s->ecoute < 0 || bind(s->ecoute, (struct sockaddr *)&adresse, sizeof(adresse)) != 0 ||
+        listen(s->ecoute, SOMAXCONN) != 0)
+    {
+        printf("Erreur: Impossible d'ecouter sur '%s'\n", chemin);
+        if (s->ecoute >= 0)
+            close(s->ecoute);
+        return false;
+    }
+    s->epoll = epoll_create1(EPOLL_CLOEXEC);
+    s->reveil = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event evenement;
+    evenement.events = EPOLLIN;
+    evenement.data.ptr = &s->ecoute;
+    epoll_ctl(s->epoll, EPOLL_CTL_ADD, s->ecoute, &evenement);
+    evenement.data.ptr = &s->reveil;
+    epoll_ctl(s->epoll, EPOLL_CTL_ADD, s->reveil, &evenement);
+    atomic_init(&s->arret, false);
+
+    pthread_mutex_init(&s->verrou, NULL);
+    pthread_cond_init(&s->travail, NULL);
+    s->nbOuvriers = nbOuvriers;
+    s->ouvriers = malloc(nbOuvriers * sizeof(pthread_t));
+    // Les signaux d'arrêt doivent interrompre epoll_wait : les ouvriers les bloquent
+    sigset_t signaux, precedents;
+    sigemptyset(&signaux);
+    sigaddset(&signaux, SIGINT);
+    sigaddset(&signaux, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signaux, &precedents);
+    for (int w = 0; w < nbOuvriers; w++)
+    {
+        OuvrierServeur *o = calloc(1, sizeof(OuvrierServeur));
+        o->serveur = s;
+        initialiserTS(&o->table);
+        creerPile(&o->stack, profondeurPileMax);
+        initialiserFlot(&o->flot);
+        creerArbre(&o->arbre);
+        pthread_create(&s->ouvriers[w], NULL, executerOuvrierServeur, o);
+    }
+    pthread_sigmask(SIG_SETMASK, &precedents, NULL);
+    return true;
+}
+
+// Boucle d'événements, jusqu'à demanderArret ou un signal d'arrêt
+void executerServeur(Serveur *s)
+{
+    struct epoll_event evenements[MAX_EVENEMENTS];
+    while (!atomic_load(&s->arret) && !signalArret)
+    {
+        int n = epoll_wait(s->epoll, evenements, MAX_EVENEMENTS, -1);
+        for (int e = 0; e < n; e++)
+        {
+            void *source = evenements[e].data.ptr;
+            if (source == &s->ecoute)
+            {
+                accepterConnexions(s);
+                continue;
+            }
+            if (source == &s->reveil)
+            {
+                rendreConnexions(s);
+                continue;
+            }
+            Connexion *c = source;
+            if (c->fd < 0)
+                continue; // fermée plus tôt dans ce même lot d'événements
+            bool ouverte = !(evenements[e].events & EPOLLERR);
+            if (ouverte && (evenements[e].events & EPOLLOUT))
+                ouverte = envoyer(s, c);
+            if (ouverte && !c->finEntree && (evenements[e].events & (EPOLLIN | EPOLLHUP)))
+                ouverte = lireConnexion(s, c) && decouperTrames(s, c);
+            else if (evenements[e].events & EPOLLHUP)
+                ouverte = false; // client parti sans attendre ses réponses
+            if (!ouverte || connexionTerminee(c))
+                fermerConnexion(s, c);
+        }
+    }
+}
+
+// Arrête la boucle depuis un autre thread
+void demanderArret(Serveur *s)
+{
+    atomic_store(&s->arret, true);
+    uint64_t un = 1;
+    if (write(s->reveil, &un, sizeof(un)) != sizeof(un))
+    {
+        // Compteur saturé : la boucle est déjà réveillée
+    }
+}
+
+// Arrête les ouvriers (les requêtes en attente sont abandonnées) et libère tout
+void arreterServeur(Serveur *s)
+{
+    pthread_mutex_lock(&s->verrou);
+    s->fin = true;
+    pthread_cond_broadcast(&s->travail);
+    pthread_mutex_unlock(&s->verrou);
+    for (int w = 0; w < s->nbOuvriers; w++)
+        pthread_join(s->ouvriers[w], NULL);
+    free(s->ouvriers);
+    while (s->nbConnexions > 0)
+    {
+        Connexion *c = s->connexions[0];
+        c->enCours = false;
+        fermerConnexion(s, c);
+    }
+    free(s->connexions);
+    free(s->file);
+    close(s->reveil);
+    close(s->epoll);
+    close(s->ecoute);
+    unlink(s->chemin);
+    pthread_mutex_destroy(&s->verrou);
+    pthread_cond_destroy(&s->travail);
+}
+
+// Client du serveur et générateur de charge (--charge)
+
+bool ecrireExactement(int fd, const void *donnees, size_t taille)
+{
+    const char *p = donnees;
+    while (taille > 0)
+    {
+        ssize_t n = send(fd, p, taille, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        taille -= n;
+    }
+    return true;
+}
+
+bool lireExactement(int fd, void *donnees, size_t taille)
+{
+    char *p = donnees;
+    while (taille > 0)
+    {
+        ssize_t n = recv(fd, p, taille, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        taille -= n;
+    }
+    return true;
+}
+
+int connecterServeur(const char *chemin)
+{
+    struct sockaddr_un adresse;
+    memset(&adresse, 0, sizeof(adresse));
+    adresse.sun_family = AF_UNIX;
+    strncpy(adresse.sun_path, chemin, sizeof(adresse.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&adresse, sizeof(adresse)) != 0)
+    {
+        printf("Erreur: Connexion au serveur '%s' impossible\n", chemin);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Envoie une requête et attend sa réponse (texte dans reponse, sans '\0') ;
+// renvoie le statut, -1 si la connexion est perdue
+int requeteServeur(int fd, uint8_t operation, const char *texte, size_t longueur, TamponOctets *reponse)
+{
+    char entete[5];
+    uint32_t taille = (uint32_t)longueur + 1;
+    memcpy(entete, &taille, 4);
+    entete[4] = (char)operation;
+    if (!ecrireExactement(fd, entete, 5) || !ecrireExactement(fd, texte, longueur) || !lireExactement(fd, entete, 5))
+        return -1;
+    memcpy(&taille, entete, 4);
+    if (taille == 0)
+        return -1;
+    reponse->taille = 0;
+    if (reponse->capacite < taille)
+    {
+        reponse->capacite = taille;
+        reponse->donnees = realloc(reponse->donnees, reponse->capacite);
+    }
+    if (!lireExactement(fd, reponse->donnees, taille - 1))
+        return -1;
+    reponse->taille = taille - 1;
+    return (uint8_t)entete[4];
+}
+
+// Requêtes envoyées à tour de rôle par chaque client, avec la réponse attendue
+// (NULL : seul le statut est vérifié)
+typedef struct
+{
+    uint8_t operation;
+    const char *texte;
+    StatutReponse statut;
+    const char *reponse;
+} RequeteCharge;
+
+static const RequeteCharge requetesCharge[] = {
+    {REQUETE_ANALYSER, "a * 3 + b * c", REPONSE_OK, "(+ (* a 3) (* b c))"},
+    {REQUETE_EVALUER, "a * 3 + b * c\na=5\nb=6\nc=7", REPONSE_OK, "57"},
+    {REQUETE_ANALYSER, "(alpha + 42) * (beta + gamma * 7) + delta", REPONSE_OK, NULL},
+    {REQUETE_EVALUER, "(x + 1) * (y + 2) * 3\nx=4\ny=-1", REPONSE_OK, "15"},
+    {REQUETE_ANALYSER, "a + * b", REPONSE_ERREUR_SYNTAXE, NULL},
+};
+
+typedef struct
+{
+    const char *chemin;
+    int nbRequetes;
+    int numero;
+    pthread_t thread;
+    HistogrammeLatences latences; // aller-retour vu du client
+    uint64_t erreurs;             // réponse inattendue ou connexion perdue
+} ClientCharge;
+
+void *executerClientCharge(void *arg)
+{
+    ClientCharge *client = arg;
+    const int nbTypes = sizeof(requetesCharge) / sizeof(requetesCharge[0]);
+    int fd = connecterServeur(client->chemin);
+    if (fd < 0)
+    {
+        client->erreurs = client->nbRequetes;
+        return NULL;
+    }
+    TamponOctets reponse = {NULL, 0, 0};
+    for (int r = 0; r < client->nbRequetes; r++)
+    {
+        const RequeteCharge *q = &requetesCharge[(r + client->numero) % nbTypes];
+        double t0 = maintenantNs();
+        int statut = requeteServeur(fd, q->operation, q->texte, strlen(q->texte), &reponse);
+        noterLatence(&client->latences, (uint64_t)(maintenantNs() - t0));
+        if (statut < 0)
+        {
+            client->erreurs += client->nbRequetes - r;
+            break;
+        }
+        if (statut != (int)q->statut || (q->reponse != NULL && (reponse.taille != strlen(q->reponse) ||
+                                                                memcmp(reponse.donnees, q->reponse, reponse.taille))))
+            client->erreurs++;
+    }
+    free(reponse.donnees);
+    close(fd);
+    return NULL;
+}
+
+// nbClients connexions envoient chacune nbRequetes requêtes, une à la fois ;
+// *latences reçoit le cumul des allers-retours, renvoie la durée totale (ns)
+double chargerServeur(const char *chemin, int nbClients, int nbRequetes, HistogrammeLatences *latences,
+                      uint64_t *erreurs)
+{
+    ClientCharge *clients = calloc(nbClients, sizeof(ClientCharge));
+    double t0 = maintenantNs();
+    for (int c = 0; c < nbClients; c++)
+    {
+        clients[c].chemin = chemin;
+        clients[c].nbRequetes = nbRequetes;
+        clients[c].numero = c;
+        pthread_create(&clients[c].thread, NULL, executerClientCharge, &clients[c]);
+    }
+    memset(latences, 0, sizeof(HistogrammeLatences));
+    *erreurs = 0;
+    for (int c = 0; c < nbClients; c++)
+    {
+        pthread_join(clients[c].thread, NULL);
+        cumulerLatences(latences, &clients[c].latences);
+        *erreurs += clients[c].erreurs;
+    }
+    double duree = maintenantNs() - t0;
+    free(clients);
+    return duree;
+}
+
+#ifdef COMPTEURS
+void ecrireHistogramme(FILE *f, const uint64_t *histogramme)
+{
+    fprintf(f, "[");
+    for (int i = 1; i <= MAX_SONDAGE; i++)
+        fprintf(f, "%s%" PRIu64, i > 1 ? ", " : "", histogramme[i]);
+    fprintf(f, "]");
+}
+
+// Écrit les compteurs en JSON sur stderr (enregistrée avec atexit dans main).
+// Les histogrammes de sondage ont une case par longueur, de 1 à MAX_SONDAGE (et plus).
+void ecrireCompteurs(void)
+{
+    static const char *nomsProductions[] = {"E -> T E'", "E' -> + T E'", "E' -> eps", "T -> F T'",
+                                            "T' -> * F T'", "T' -> eps", "F -> ( E )", "F -> n", "erreur"};
+    FILE *f = stderr;
+    fprintf(f, "{\n  \"automate\": [");
+    bool premier = true;
+    for (int etat = 0; etat < MAX_STATES; etat++)
+    {
+        uint64_t t = compteurs.transitions[etat];
+        if (t == 0 && compteurs.sautes[etat] == 0 && compteurs.echecs[etat] == 0)
+            continue;
+        fprintf(f, "%s\n    {\"etat\": %d, \"transitions\": %" PRIu64 ", \"sautes\": %" PRIu64
+                   ", \"echecs\": %" PRIu64 ", \"rang_csr_moyen\": %.3f}",
+                premier ? "" : ",", etat, t, compteurs.sautes[etat], compteurs.echecs[etat],
+                t ? (double)compteurs.rangCSR[etat] / t : 0.0);
+        premier = false;
+    }
+    fprintf(f, "\n  ],\n  \"table_symboles\": {\n    \"sondages_recherche\": ");
+    ecrireHistogramme(f, compteurs.sondagesRecherche);
+    fprintf(f, ",\n    \"sondages_ajout\": ");
+    ecrireHistogramme(f, compteurs.sondagesAjout);
+    fprintf(f, ",\n    \"symboles\": %d,\n    \"cases\": %" PRIu32 ",\n    \"remplissage\": %.4f,\n"
+               "    \"remplissage_max\": %.4f,\n    \"agrandissements\": %" PRIu64 "\n  },\n",
+            compteurs.symboles, compteurs.cases,
+            compteurs.cases ? (double)compteurs.symboles / compteurs.cases : 0.0,
+            compteurs.remplissageMax, compteurs.agrandissements);
+    fprintf(f, "  \"analyseur\": {\n    \"productions\": {");
+    for (int prod = 0; prod <= PROD_ERROR; prod++)
+        fprintf(f, "%s\"%s\": %" PRIu64, prod ? ", " : "", nomsProductions[prod], compteurs.productions[prod]);
+    fprintf(f, "},\n    \"profondeur_pile_max\": %zu\n  }\n}\n", compteurs.profondeurPileMax);
+}
+#endif
+
+// --- BENCHMARKS ---
+
+double maintenantNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Résultats lisibles par machine, une mesure par ligne :
+// benchmark <tab> cas <tab> métrique <tab> valeur <tab> unité
+#define FICHIER_BENCH "bench_output.txt"
+FILE *sortieBench = NULL;
+
+void ecrireMesure(const char *benchmark, const char *cas, const char *metrique, double valeur, const char *unite)
+{
+    if (sortieBench != NULL)
+        fprintf(sortieBench, "%s\t%s\t%s\t%.6g\t%s\n", benchmark, cas, metrique, valeur, unite);
+}
+
+typedef void (*FonctionMesuree)(void *contexte);
+
+int comparerDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Durée médiane (ns) de repetitions exécutions, après echauffement exécutions
+double mesurer(FonctionMesuree f, void *contexte, int echauffement, int repetitions)
+{
+    double durees[64];
+    if (repetitions > 64)
+        repetitions = 64;
+    for (int r = 0; r < echauffement; r++)
+        f(contexte);
+    for (int r = 0; r < repetitions; r++)
+    {
+        double t0 = maintenantNs();
+        f(contexte);
+        durees[r] = maintenantNs() - t0;
+    }
+    qsort(durees, repetitions, sizeof(double), comparerDoubles);
+    return durees[repetitions / 2];
+}
+
+// Générateur pseudo-aléatoire déterministe (xorshift64) des corpus
+uint64_t aleatoire(uint64_t *graine)
+{
+    *graine ^= *graine << 13;
+    *graine ^= *graine >> 7;
+    *graine ^= *graine << 17;
+    return *graine;
+}
+
+// Corpus riche en identificateurs (jeu limité de noms pour ne pas saturer la TS)
+char *genererCorpusIdentificateurs(int taille)
+{
+    const char *noms[] = {"alpha", "beta", "gamma", "delta", "compteur", "indice",
+                          "valeurMaximale", "x", "y", "resultatIntermediaire"};
+    char *corpus = malloc(taille + 1);
+    int pos = 0;
+    int i = 0;
+    while (pos < taille - 32)
+    {
+        pos += sprintf(corpus + pos, "%s * ", noms[i % 10]);
+        i++;
+    }
+    corpus[pos] = '\0';
+    return corpus;
+}
+
+// Corpus dominé par des commentaires : corps de commentaire et suites de '*' avant "*/"
+char *genererCorpusCommentaires(int taille)
+{
+    char *corpus = malloc(taille + 1);
+    int pos = 0;
+    while (pos < taille - 80)
+    {
+        pos += sprintf(corpus + pos, "/* commentaire de licence, ligne generee ** fin */\n    x + ");
+    }
+    corpus[pos] = '\0';
+    return corpus;
+}
+
+// Longue chaîne de + et * entre identificateurs et nombres, syntaxiquement correcte
+char *genererCorpusChaine(int taille)
+{
+    const char *termes[] = {"alpha * 42 + ", "beta + ", "compteur * indice * 7 + ", "x * y + "};
+    char *corpus = malloc(taille + 1);
+    int pos = 0;
+    int i = 0;
+    while (pos < taille - 32)
+    {
+        pos += sprintf(corpus + pos, "%s", termes[i % 4]);
+        i++;
+    }
+    pos += sprintf(corpus + pos, "x");
+    return corpus;
+}
+
+// Temps moyen par octet pour analyser tout le corpus avec lexical_analyzer
+double mesurerLexeur(CSRmatrice *matrice, const char *corpus, int repetitions)
+{
+    Source src;
+    sourceDepuisChaine(&src, corpus);
+    double meilleur = 0;
+
+    for (int r = 0; r < repetitions; r++)
+    {
+        TS table;
+        initialiserTS(&table);
+        double debut = maintenantNs();
+        int64_t index = 0;
+        while (corpus[index] != '\0')
+        {
+            int64_t avant = index, debut;
+            int symbole;
+            Terminal terminal;
+            lexical_analyzer(matrice, &src, &index, &table, &debut, &symbole, &terminal);
+            if (index == avant)
+                index++;
+        }
+        double duree = maintenantNs() - debut;
+        libererTS(&table);
+        if (r == 0 || duree < meilleur)
+            meilleur = duree;
+    }
+    return meilleur / src.longueur;
+}
+
+void benchmarkLexeur()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    CSRmatrice matriceDense;
+    initialiserMatrcie(&matriceDense);
+    compilerMatrice(&matriceDense);
+
+    const int taille = 4 * 1024 * 1024;
+    char *corpus[2] = {genererCorpusIdentificateurs(taille), genererCorpusCommentaires(taille)};
+    const char *noms[2] = {"identificateurs", "commentaires"};
+
+    printf("--- BENCHMARK LEXEUR (%d classes de caracteres) ---\n", matriceDense.dense.nbClasses);
+    for (int i = 0; i < 2; i++)
+    {
+        double csr = mesurerLexeur(&matrice, corpus[i], 5);
+        double dense = mesurerLexeur(&matriceDense, corpus[i], 5);
+        printf("%-16s CSR: %6.2f ns/octet  dense: %6.2f ns/octet  gain: x%.2f\n",
+               noms[i], csr, dense, csr / dense);
+        ecrireMesure("lexeur", noms[i], "csr", csr, "ns/octet");
+        ecrireMesure("lexeur", noms[i], "dense", dense, "ns/octet");
+        free(corpus[i]);
+    }
+}
+
+// Corpus en commentaires : texte français accentué, ou presque entièrement multi-octets
+char *genererCorpusUTF8(int taille, bool dense)
+{
+    const char *francais = "/* \xc3\xa9l\xc3\xa9ment tr\xc3\xa8s d\xc3\xa9j\xc3\xa0 utilis\xc3\xa9, "
+                           "cha\xc3\xae" "ne fran\xc3\xa7" "aise \xc5\x93uvre */\n    x + ";
+    const char *multiOctets = "/* \xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xce\xb1\xce\xb2\xce\xb3"
+                              "\xf0\x9f\x98\x80\xe2\x82\xac\xd0\x96\xd0\xb8\xe6\x96\x87\xe5\xad\x97 */x+";
+    char *corpus = malloc(taille + 1);
+    int pos = 0;
+    while (pos < taille - 80)
+    {
+        pos += sprintf(corpus + pos, "%s", dense ? multiOctets : francais);
+    }
+    pos += sprintf(corpus + pos, "x");
+    return corpus;
+}
+
+typedef struct
+{
+    const char *texte;
+    int64_t longueur;
+    bool sequentiel;
+    int64_t resultat;
+} ContexteUTF8;
+
+void phaseValidationUTF8(void *contexte)
+{
+    ContexteUTF8 *c = contexte;
+    c->resultat = c->sequentiel ? validerUTF8Sequentiel(c->texte, 0, c->longueur) : validerUTF8(c->texte, c->longueur, NULL);
+}
+
+typedef struct
+{
+    CSRmatrice *matrice;
+    Source *src;
+    FlotJetons flot;
+} ContexteTokenize;
+
+void phaseTokenize(void *contexte)
+{
+    ContexteTokenize *c = contexte;
+    TS table;
+    initialiserTS(&table);
+    c->flot.nb = 0;
+    tokenize(c->matrice, c->src, &table, &c->flot, NULL);
+    libererTS(&table);
+}
+
+// Débit de la validation UTF-8 (vectorielle et séquentielle) et son coût rapporté
+// à celui du lexeur sur la même entrée
+void benchmarkUTF8()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    const int taille = 16 * 1024 * 1024;
+    const char *cas[] = {"ascii", "francais", "multi_octets"};
+    char *corpus[] = {genererCorpusChaine(taille), genererCorpusUTF8(taille, false), genererCorpusUTF8(taille, true)};
+
+#if defined(__AVX2__)
+    const char *version = "AVX2";
+#elif defined(__SSE2__)
+    const char *version = "SSE2";
+#else
+    const char *version = "scalaire";
+#endif
+    printf("--- BENCHMARK VALIDATION UTF-8 (16 Mo, %s) ---\n", version);
+    for (int c = 0; c < 3; c++)
+    {
+        ContexteUTF8 validation = {corpus[c], (int64_t)strlen(corpus[c]), false, 0};
+        double vectorielle = mesurer(phaseValidationUTF8, &validation, 1, 9);
+        validation.sequentiel = true;
+        double sequentielle = mesurer(phaseValidationUTF8, &validation, 1, 9);
+
+        Source src;
+        sourceDepuisChaine(&src, corpus[c]);
+        ContexteTokenize lexeur;
+        lexeur.matrice = &matrice;
+        lexeur.src = &src;
+        initialiserFlot(&lexeur.flot);
+        double lexage = mesurer(phaseTokenize, &lexeur, 1, 5);
+        libererFlot(&lexeur.flot);
+
+        double octets = (double)validation.longueur;
+        printf("%-14s validation: %6.2f Go/s  sequentielle: %6.2f Go/s  lexeur: %6.3f Go/s  cout: %5.2f %%%s\n",
+               cas[c], octets / vectorielle, octets / sequentielle, octets / lexage, 100 * vectorielle / lexage,
+               validation.resultat < 0 && src.erreurUTF8 < 0 ? "" : " ERREUR");
+        ecrireMesure("utf8", cas[c], "validation", octets / vectorielle, "Go/s");
+        ecrireMesure("utf8", cas[c], "sequentielle", octets / sequentielle, "Go/s");
+        ecrireMesure("utf8", cas[c], "cout_lexeur", 100 * vectorielle / lexage, "%");
+        free(corpus[c]);
+    }
+}
+
+// Analyse de parenthèses imbriquées : le temps par jeton doit rester constant
+void benchmarkPile()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    printf("--- BENCHMARK PILE D'ANALYSE ---\n");
+    for (int profondeur = 10000; profondeur <= 1000000; profondeur *= 10)
+    {
+        char *corpus = malloc(2 * profondeur + 2);
+        memset(corpus, '(', profondeur);
+        corpus[profondeur] = 'x';
+        memset(corpus + profondeur + 1, ')', profondeur);
+        corpus[2 * profondeur + 1] = '\0';
+
+        Source src;
+        sourceDepuisChaine(&src, corpus);
+        TS table;
+        initialiserTS(&table);
+        FlotJetons flot;
+        initialiserFlot(&flot);
+        tokenize(&matrice, &src, &table, &flot, NULL);
+
+        ParseStack stack;
+        creerPile(&stack, PROFONDEUR_PILE_MAX);
+        size_t k;
+        StackElement x;
+        double t0 = maintenantNs();
+        ResultatAnalyse resultat = analyserLL1(&flot, &stack, NULL, &k, &x);
+        double duree = maintenantNs() - t0;
+        printf("%8d niveaux  %6.2f ns/jeton  profondeur max: %zu  %s\n", profondeur, duree / flot.nb,
+               stack.profondeurMax, resultat == ANALYSE_REUSSIE ? "ok" : "erreur");
+        char cas[32];
+        snprintf(cas, sizeof(cas), "%d", profondeur);
+        ecrireMesure("pile", cas, "analyse", duree / flot.nb, "ns/jeton");
+
+        libererPile(&stack);
+        libererFlot(&flot);
+        libererTS(&table);
+        free(corpus);
+    }
+}
+
+// Analyse avec et sans construction de l'arbre ; l'arène est réutilisée d'une
+// analyse à l'autre (aucune allocation après la première)
+void benchmarkArbre()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    char *corpus = genererCorpusChaine(16 * 1024 * 1024);
+    Source src;
+    sourceDepuisChaine(&src, corpus);
+    TS table;
+    initialiserTS(&table);
+    FlotJetons flot;
+    initialiserFlot(&flot);
+    tokenize(&matrice, &src, &table, &flot, NULL);
+
+    ParseStack stack;
+    creerPile(&stack, PROFONDEUR_PILE_MAX);
+    ArbreSyntaxe arbre;
+    creerArbre(&arbre);
+    size_t k;
+    StackElement x;
+    double sans = 0, avec = 0;
+    for (int r = 0; r < 5; r++)
+    {
+        double t0 = maintenantNs();
+        analyserLL1(&flot, &stack, NULL, &k, &x);
+        double t1 = maintenantNs();
+        analyserLL1(&flot, &stack, &arbre, &k, &x);
+        double t2 = maintenantNs();
+        if (r == 0 || t1 - t0 < sans)
+            sans = t1 - t0;
+        if (r == 0 || t2 - t1 < avec)
+            avec = t2 - t1;
+    }
+
+    printf("--- BENCHMARK ARBRE SYNTAXIQUE ---\n");
+    printf("%zu jetons, %u noeuds  sans arbre: %5.2f ns/jeton  avec arbre: %5.2f ns/jeton\n",
+           flot.nb, arbre.nb, sans / flot.nb, avec / flot.nb);
+    printf("memoire: %zu octets/noeud (%.2f avec la capacite de l'arene)\n",
+           sizeof(Noeud), (double)arbre.capacite * sizeof(Noeud) / arbre.nb);
+    ecrireMesure("arbre", "chaines", "sans_arbre", sans / flot.nb, "ns/jeton");
+    ecrireMesure("arbre", "chaines", "avec_arbre", avec / flot.nb, "ns/jeton");
+    ecrireMesure("arbre", "chaines", "memoire", (double)arbre.capacite * sizeof(Noeud) / arbre.nb, "octets/noeud");
+
+    libererArbre(&arbre);
+    libererPile(&stack);
+    libererFlot(&flot);
+    libererTS(&table);
+    free(corpus);
+}
+
+// Lignes évaluées par seconde : code compilé par lots contre parcours de l'arbre
+void benchmarkEvaluation()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    const char *formule = "a * 3 + b * c + (a + 7) * (b + c * 2) + d";
+    Source src;
+    sourceDepuisChaine(&src, formule);
+    TS table;
+    initialiserTS(&table);
+    FlotJetons flot;
+    initialiserFlot(&flot);
+    tokenize(&matrice, &src, &table, &flot, NULL);
+    ParseStack stack;
+    creerPile(&stack, PROFONDEUR_PILE_MAX);
+    ArbreSyntaxe arbre;
+    creerArbre(&arbre);
+    size_t k;
+    StackElement x;
+    analyserLL1(&flot, &stack, &arbre, &k, &x);
+
+    const size_t nbLignes = 10000000;
+    int64_t **colonnes = calloc(table.size, sizeof(int64_t *));
+    uint64_t graine = 88172645463325252ull;
+    for (int id = 0; id < table.size; id++)
+    {
+        if (table.entries[id].type != IDENTIFIER)
+            continue;
+        colonnes[id] = malloc(nbLignes * sizeof(int64_t));
+        for (size_t i = 0; i < nbLignes; i++)
+        {
+            graine ^= graine << 13;
+            graine ^= graine >> 7;
+            graine ^= graine << 17;
+            colonnes[id][i] = (int64_t)(graine % 1000);
+        }
+    }
+    int64_t *resultat = malloc(nbLignes * sizeof(int64_t));
+
+    Programme prog;
+    compilerArbre(&arbre, &table, &prog);
+    double t0 = maintenantNs();
+    evaluerLot(&prog, (const int64_t *const *)colonnes, resultat, nbLignes);
+    double t1 = maintenantNs();
+    size_t erreurs = 0;
+    for (size_t i = 0; i < nbLignes; i++)
+        erreurs += (uint64_t)resultat[i] != evaluerNoeud(&arbre, arbre.racine, &table, (const int64_t *const *)colonnes, i);
+    double t2 = maintenantNs();
+
+    printf("--- BENCHMARK EVALUATION (%s) ---\n", formule);
+    printf("%u instructions  lots: %7.1f Mlignes/s  arbre: %7.1f Mlignes/s  (%zu differences)\n",
+           prog.nb, nbLignes / (t1 - t0) * 1e3, nbLignes / (t2 - t1) * 1e3, erreurs);
+    ecrireMesure("evaluation", "formule", "lots", nbLignes / (t1 - t0) * 1e9, "lignes/s");
+    ecrireMesure("evaluation", "formule", "arbre", nbLignes / (t2 - t1) * 1e9, "lignes/s");
+
+    libererProgramme(&prog);
+    for (int id = 0; id < table.size; id++)
+        free(colonnes[id]);
+    free(colonnes);
+    free(resultat);
+    libererArbre(&arbre);
+    libererPile(&stack);
+    libererFlot(&flot);
+    libererTS(&table);
+}
+
+// Lignes évaluées par seconde, une ligne à la fois (tableau de variables par
+// ligne) : parcours de l'arbre, interpréteur du programme et code machine ; la
+// version par lots (colonnes) sert de repère
+void benchmarkJIT()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    const char *formules[] = {"a * 3 + b * c + (a + 7) * (b + c * 2) + d",
+                              "(a - b) / (c mod 7 + 1) + (a < b) * d - (c >= d) * 100"};
+    const size_t nbLignes = 4000000;
+
+    printf("--- BENCHMARK CODE MACHINE ---\n");
+    for (int f = 0; f < 2; f++)
+    {
+        Source src;
+        sourceDepuisChaine(&src, formules[f]);
+        TS table;
+        initialiserTS(&table);
+        FlotJetons flot;
+        initialiserFlot(&flot);
+        tokenize(&matrice, &src, &table, &flot, NULL);
+        ParseStack stack;
+        creerPile(&stack, PROFONDEUR_PILE_MAX);
+        ArbreSyntaxe arbre;
+        creerArbre(&arbre);
+        size_t k;
+        StackElement x;
+        analyserPratt(&flot, &stack, &arbre, &k, &x);
+        Programme prog;
+        compilerArbre(&arbre, &table, &prog);
+        CodeJIT jit;
+        bool natif = compilerJIT(&prog, &jit);
+
+        // Variables ligne par ligne (pour l'appel) et en colonnes (pour les lots)
+        int64_t *lignes = malloc(nbLignes * table.size * sizeof(int64_t));
+        int64_t **colonnes = calloc(table.size, sizeof(int64_t *));
+        for (int id = 0; id < table.size; id++)
+            colonnes[id] = malloc(nbLignes * sizeof(int64_t));
+        uint64_t graine = 88172645463325252ull;
+        for (size_t i = 0; i < nbLignes; i++)
+        {
+            for (int id = 0; id < table.size; id++)
+            {
+                int64_t v = (int64_t)(aleatoire(&graine) % 1000);
+                lignes[i * table.size + id] = v;
+                colonnes[id][i] = v;
+            }
+        }
+        int64_t *resultat = malloc(nbLignes * sizeof(int64_t));
+
+        double t0 = maintenantNs();
+        uint64_t sommeArbre = 0;
+        for (size_t i = 0; i < nbLignes; i++)
+            sommeArbre += evaluerNoeud(&arbre, arbre.racine, &table, (const int64_t *const *)colonnes, i);
+        double t1 = maintenantNs();
+        uint64_t sommeInterpreteur = 0;
+        for (size_t i = 0; i < nbLignes; i++)
+            sommeInterpreteur += (uint64_t)interpreterProgramme(&prog, lignes + i * table.size);
+        double t2 = maintenantNs();
+        uint64_t sommeJIT = 0;
+        for (size_t i = 0; i < nbLignes; i++)
+            sommeJIT += (uint64_t)executerJIT(&jit, lignes + i * table.size);
+        double t3 = maintenantNs();
+        evaluerLot(&prog, (const int64_t *const *)colonnes, resultat, nbLignes);
+        double t4 = maintenantNs();
+        uint64_t sommeLots = 0;
+        for (size_t i = 0; i < nbLignes; i++)
+            sommeLots += (uint64_t)resultat[i];
+
+        bool identiques = sommeArbre == sommeInterpreteur && sommeArbre == sommeJIT && sommeArbre == sommeLots;
+        printf("%s\n  arbre: %6.1f  interpreteur: %6.1f  %s: %6.1f  lots: %6.1f Mlignes/s  gain: x%.2f  %s\n",
+               formules[f], nbLignes / (t1 - t0) * 1e3, nbLignes / (t2 - t1) * 1e3,
+               natif ? "code machine" : "repli (interpreteur)", nbLignes / (t3 - t2) * 1e3,
+               nbLignes / (t4 - t3) * 1e3, (t2 - t1) / (t3 - t2), identiques ? "identique" : "DIFFERENT");
+        const char *cas = f == 0 ? "arithmetique" : "division_comparaisons";
+        ecrireMesure("jit", cas, "arbre", nbLignes / (t1 - t0) * 1e9, "lignes/s");
+        ecrireMesure("jit", cas, "interpreteur", nbLignes / (t2 - t1) * 1e9, "lignes/s");
+        ecrireMesure("jit", cas, natif ? "code_machine" : "repli", nbLignes / (t3 - t2) * 1e9, "lignes/s");
+        ecrireMesure("jit", cas, "lots", nbLignes / (t4 - t3) * 1e9, "lignes/s");
+
+        libererJIT(&jit);
+        libererProgramme(&prog);
+        for (int id = 0; id < table.size; id++)
+            free(colonnes[id]);
+        free(colonnes);
+        free(lignes);
+        free(resultat);
+        libererArbre(&arbre);
+        libererPile(&stack);
+        libererFlot(&flot);
+        libererTS(&table);
+    }
+}
+
+// Passage à l'échelle de l'analyse par lots, de 1 thread au nombre de coeurs
+void benchmarkLot()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    const char *formes[] = {"a%d * (b + %d) * c\n", "x%d + y * %d + (z * (t + u))\n",
+                            "(((p%d))) * q + %d * r * s + v\n", "alpha%d + beta * gamma + %d\n"};
+    const int nbLignes = 2000000;
+    char *texte = malloc((size_t)nbLignes * 48);
+    int64_t longueur = 0;
+    for (int i = 0; i < nbLignes; i++)
+        longueur += sprintf(texte + longueur, formes[i % 4], i % 5000, i);
+
+    long nbCoeurs = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("--- BENCHMARK ANALYSE PAR LOTS (%d lignes, %ld coeurs) ---\n", nbLignes, nbCoeurs);
+    double reference = 0;
+    for (int n = 1; n <= nbCoeurs; n *= 2)
+    {
+        TS table;
+        initialiserTS(&table);
+        size_t nb;
+        double t0 = maintenantNs();
+        ResultatLigne *resultats = analyserLot(&matrice, texte, longueur, n, &table, &nb);
+        double duree = maintenantNs() - t0;
+        if (n == 1)
+            reference = duree;
+        size_t reussies = 0;
+        for (size_t i = 0; i < nb; i++)
+            reussies += resultats[i].resultat == ANALYSE_REUSSIE;
+        printf("%3d threads  %7.2f Mlignes/s  acceleration: x%.2f  (%zu reussies, %d symboles)\n", n,
+               nb / duree * 1e3, reference / duree, reussies, table.size);
+        char cas[32];
+        snprintf(cas, sizeof(cas), "%d_threads", n);
+        ecrireMesure("lot", cas, "analyse", nb / duree * 1e9, "lignes/s");
+        libererResultats(resultats, nb);
+        libererTS(&table);
+        if (n < nbCoeurs && n * 2 > nbCoeurs)
+            n = nbCoeurs / 2;
+    }
+    free(texte);
+}
+
+bool flotsIdentiques(FlotJetons *a, FlotJetons *b)
+{
+    return a->nb == b->nb && memcmp(a->type, b->type, a->nb) == 0 && memcmp(a->terminal, b->terminal, a->nb) == 0 &&
+           memcmp(a->debut, b->debut, a->nb * sizeof(int64_t)) == 0 &&
+           memcmp(a->longueur, b->longueur, a->nb * sizeof(uint32_t)) == 0 &&
+           memcmp(a->symbole, b->symbole, a->nb * sizeof(int32_t)) == 0;
+}
+
+// Analyse lexicale parallèle d'un gros corpus mêlant commentaires et expressions :
+// débit et identité avec le flot séquentiel (y compris avec de petites tranches
+// qui coupent lexèmes et commentaires)
+void benchmarkLexeurParallele()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    const int64_t taille = 64 * 1024 * 1024;
+    char *corpus = malloc(taille + 1);
+    int64_t pos = 0;
+    for (int i = 0; pos < taille - 200; i++)
+    {
+        if (i % 7 == 0)
+            pos += sprintf(corpus + pos, "/* bloc %d ** de commentaire\n sur deux lignes */ ", i);
+        pos += sprintf(corpus + pos, "identificateur%d * (x%d + 1234567) <= y >= z == t; ", i % 100000, i % 77);
+    }
+    corpus[pos] = '\0';
+    Source src;
+    sourceDepuisChaine(&src, corpus);
+
+    TS tableSeq;
+    initialiserTS(&tableSeq);
+    FlotJetons seq;
+    initialiserFlot(&seq);
+    double t0 = maintenantNs();
+    tokenize(&matrice, &src, &tableSeq, &seq, NULL);
+    double sequentiel = maintenantNs() - t0;
+
+    long nbCoeurs = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("--- BENCHMARK LEXEUR PARALLELE (%" PRId64 " Mo, %ld coeurs) ---\n", pos >> 20, nbCoeurs);
+    printf("sequentiel  %7.1f Mo/s\n", pos / sequentiel * 1e3);
+    const int64_t tranches[2] = {0, 4093}; // 0 : taille adaptée au nombre de threads
+    for (int n = 1; n <= nbCoeurs; n *= 2)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            int64_t tranche = tranches[i] ? tranches[i] : pos / (4 * n) + 1;
+            if (tranche < TAILLE_TRANCHE_MIN && tranches[i] == 0)
+                tranche = TAILLE_TRANCHE_MIN;
+            TS table;
+            initialiserTS(&table);
+            FlotJetons flot;
+            initialiserFlot(&flot);
+            double t1 = maintenantNs();
+            tokenizeParallele(&matrice, &src, &table, &flot, n, tranche, NULL);
+            double duree = maintenantNs() - t1;
+            bool identique = flotsIdentiques(&flot, &seq) && table.size == tableSeq.size &&
+                             memcmp(table.arene, tableSeq.arene, table.tailleArene) == 0;
+            printf("%3d threads  tranches de %9" PRId64 " o  %7.1f Mo/s  %s\n", n, tranche, pos / duree * 1e3,
+                   identique ? "identique" : "DIFFERENT");
+            char cas[48];
+            snprintf(cas, sizeof(cas), "%d_threads_%" PRId64, n, tranche);
+            ecrireMesure("parallele", cas, "tokenize", pos / duree * 1e3, "Mo/s");
+            libererFlot(&flot);
+            libererTS(&table);
+        }
+        if (n < nbCoeurs && n * 2 > nbCoeurs)
+            n = nbCoeurs / 2;
+    }
+    libererFlot(&seq);
+    libererTS(&tableSeq);
+    free(corpus);
+}
+
+// Latence d'une petite modification comparée à une nouvelle analyse complète, pour
+// plusieurs tailles de document ; le résultat est vérifié contre une analyse
+// complète du texte modifié
+void benchmarkIncremental()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    printf("--- BENCHMARK ANALYSE INCREMENTALE ---\n");
+    const int tailles[] = {1, 4, 16}; // Mo
+    const char *termes[] = {"(alpha + 42) * ", "beta * (gamma + (x * 3)) + ", "/* note */ compteur + ", "y * z + "};
+    // Modifications : changer une lettre, insérer un opérande, un commentaire, une parenthèse
+    const char *insertions[] = {"q", " + w", "/* ", " */", "(", ")", "7", ""};
+    for (int t = 0; t < 3; t++)
+    {
+        const int taille = tailles[t] * 1024 * 1024;
+        char *corpus = malloc(taille + 1);
+        int pos = 0;
+        for (int i = 0; pos < taille - 64; i++)
+            pos += sprintf(corpus + pos, "%s", termes[i % 4]);
+        pos += sprintf(corpus + pos, "fin");
+
+        Document doc;
+        double t0 = maintenantNs();
+        ouvrirDocument(&doc, &matrice, corpus, pos);
+        double complet = maintenantNs() - t0;
+
+        uint64_t graine = 88172645463325252ull;
+        const int nbModifications = 2000;
+        double total = 0;
+        int differences = 0;
+        for (int m = 0; m < nbModifications; m++)
+        {
+            graine ^= graine << 13;
+            graine ^= graine >> 7;
+            graine ^= graine << 17;
+            int64_t offset = (int64_t)(graine % (uint64_t)doc.longueur);
+            const char *insere = insertions[(graine >> 32) % 8];
+            int64_t supprime = (graine >> 40) % 3;
+            if (offset + supprime > doc.longueur)
+                supprime = doc.longueur - offset;
+
+            double t1 = maintenantNs();
+            modifierDocument(&doc, offset, supprime, insere, strlen(insere));
+            total += maintenantNs() - t1;
+
+            if (m % 200 == 199)
+            {
+                char *texte = texteDocument(&doc);
+                Document reference;
+                ouvrirDocument(&reference, &matrice, texte, doc.longueur);
+                FlotJetons a, b;
+                jetonsDocument(&doc, &a);
+                jetonsDocument(&reference, &b);
+                bool identique = a.nb == b.nb && memcmp(a.type, b.type, a.nb) == 0 &&
+                                 memcmp(a.terminal, b.terminal, a.nb) == 0 &&
+                                 memcmp(a.debut, b.debut, a.nb * sizeof(int64_t)) == 0 &&
+                                 memcmp(a.longueur, b.longueur, a.nb * sizeof(uint32_t)) == 0 &&
+                                 doc.resultat == reference.resultat &&
+                                 jetonErreurDocument(&doc) == jetonErreurDocument(&reference);
+                differences += !identique;
+                libererFlot(&a);
+                libererFlot(&b);
+                fermerDocument(&reference);
+                free(texte);
+            }
+        }
+
+        printf("%2d Mo, %8zu jetons : analyse complete %8.2f ms  modification %8.2f us en moyenne  (%d differences)\n",
+               tailles[t], doc.nbJetons, complet / 1e6, total / nbModifications / 1e3, differences);
+        char cas[16];
+        snprintf(cas, sizeof(cas), "%dMo", tailles[t]);
+        ecrireMesure("incremental", cas, "complete", complet, "ns");
+        ecrireMesure("incremental", cas, "modification", total / nbModifications, "ns");
+        fermerDocument(&doc);
+        free(corpus);
+    }
+}
+
+// --- SUITE : corpus synthétiques x phases ---
+// Chaque corpus est une expression correcte de la grammaire
+
+// Identificateurs tous différents jusqu'à nbDistincts (sollicite la TS)
+char *genererSuiteIdentificateurs(int taille)
+{
+    const int nbDistincts = 1 << 20;
+    char *corpus = malloc(taille + 1);
+    int pos = 0;
+    uint64_t graine = 1;
+    while (pos < taille - 32)
+        pos += sprintf(corpus + pos, "v%x %c ", (unsigned)(aleatoire(&graine) % nbDistincts),
+                       graine & 256 ? '+' : '*');
+    pos += sprintf(corpus + pos, "x");
+    return corpus;
+}
+
+// Nombres de 12 à 19 chiffres
+char *genererSuiteNombres(int taille)
+{
+    char *corpus = malloc(taille + 1);
+    int pos = 0;
+    uint64_t graine = 2;
+    while (pos < taille - 32)
+    {
+        uint64_t chiffres = 12 + aleatoire(&graine) % 8;
+        uint64_t valeur = aleatoire(&graine) % 1000000000000000000ull;
+        pos += sprintf(corpus + pos, "%0*" PRIu64 " + ", (int)chiffres, valeur);
+    }
+    pos += sprintf(corpus + pos, "0");
+    return corpus;
+}
+
+// Commentaires longs (corps de commentaire parcouru par chercherEtoile), avec des
+// '*' isolés dans le corps
+char *genererSuiteCommentaires(int taille)
+{
+    char *corpus = malloc(taille + 1);
+    int pos = 0;
+    uint64_t graine = 3;
+    while (pos < taille - 400)
+    {
+        pos += sprintf(corpus + pos, "/*");
+        int longueur = 100 + aleatoire(&graine) % 200;
+        for (int i = 0; i < longueur; i++)
+            corpus[pos++] = i % 61 == 60 ? '*' : "abcdefgh ijklmnop\n"[aleatoire(&graine) % 18];
+        pos += sprintf(corpus + pos, "**/ x + ");
+    }
+    pos += sprintf(corpus + pos, "x");
+    return corpus;
+}
+
+// Une seule imbrication de parenthèses aussi profonde que la taille le permet
+char *genererSuiteImbrication(int taille)
+{
+    char *corpus = malloc(taille + 1);
+    int profondeur = (taille - 1) / 2;
+    memset(corpus, '(', profondeur);
+    corpus[profondeur] = 'x';
+    memset(corpus + profondeur + 1, ')', profondeur);
+    corpus[2 * profondeur + 1] = '\0';
+    return corpus;
+}
+
+typedef struct
+{
+    CSRmatrice *matrice;
+    Source src;
+    TS table;
+    FlotJetons flot;
+    ParseStack stack;
+    size_t *symboles; // indices des jetons identificateurs et nombres
+    size_t nbSymboles;
+} ContexteSuite;
+
+// initialiserMatrcie ne fait que pointer vers les tables de automate.h : seule la
+// construction de la table dense est mesurée (la matrice reste compilée pour la suite)
+void phaseMatrice(void *contexte)
+{
+    ContexteSuite *c = contexte;
+    for (int i = 0; i < 100; i++)
+        compilerMatrice(c->matrice);
+}
+
+void phaseLexeur(void *contexte)
+{
+    ContexteSuite *c = contexte;
+    libererTS(&c->table);
+    initialiserTS(&c->table);
+    c->flot.nb = 0;
+    tokenize(c->matrice, &c->src, &c->table, &c->flot, NULL);
+}
+
+void phaseAjout(void *contexte)
+{
+    ContexteSuite *c = contexte;
+    TS table;
+    initialiserTS(&table);
+    for (size_t i = 0; i < c->nbSymboles; i++)
+    {
+        size_t k = c->symboles[i];
+        ajoutSymbole(&table, c->src.donnees + c->flot.debut[k], c->flot.longueur[k], c->flot.type[k]);
+    }
+    libererTS(&table);
+}
+
+void phaseRecherche(void *contexte)
+{
+    ContexteSuite *c = contexte;
+    int trouves = 0;
+    for (size_t i = 0; i < c->nbSymboles; i++)
+    {
+        size_t k = c->symboles[i];
+        trouves += chercherSymbole(&c->table, c->src.donnees + c->flot.debut[k], c->flot.longueur[k]) >= 0;
+    }
+    if (trouves < 0)
+        printf("?");
+}
+
+void phaseAnalyse(void *contexte)
+{
+    ContexteSuite *c = contexte;
+    size_t k;
+    StackElement x;
+    analyserLL1(&c->flot, &c->stack, NULL, &k, &x);
+}
+
+// Temps de chaque phase (construction de la table dense, lexeur, TS, analyse LL(1)) sur
+// chaque corpus : médiane de 5 exécutions après 1 d'échauffement
+void benchmarkSuite()
+{
+    const int taille = 16 * 1024 * 1024;
+    const char *noms[] = {"identificateurs", "nombres", "commentaires", "imbrication", "chaines"};
+    char *(*generateurs[])(int) = {genererSuiteIdentificateurs, genererSuiteNombres, genererSuiteCommentaires,
+                                   genererSuiteImbrication, genererCorpusChaine};
+    CSRmatrice matrice;
+    ContexteSuite c;
+    c.matrice = &matrice;
+
+    printf("--- BENCHMARK SUITE (mediane de 5, 1 echauffement) ---\n");
+    initialiserMatrcie(&matrice);
+    double matriceNs = mesurer(phaseMatrice, &c, 1, 5) / 100;
+    printf("compilerMatrice: %8.0f ns/op\n", matriceNs);
+    ecrireMesure("suite", "-", "compilerMatrice", matriceNs, "ns/op");
+
+    printf("%-16s %10s %12s %12s %12s %12s\n", "corpus", "lexeur Mo/s", "jetons/s", "ajout ns/op",
+           "cherche ns/op", "LL(1) jetons/s");
+    for (int i = 0; i < 5; i++)
+    {
+        char *corpus = generateurs[i](taille);
+        sourceDepuisChaine(&c.src, corpus);
+        initialiserTS(&c.table);
+        initialiserFlot(&c.flot);
+        creerPile(&c.stack, PROFONDEUR_PILE_MAX);
+
+        double lexeur = mesurer(phaseLexeur, &c, 1, 5);
+        c.symboles = malloc(c.flot.nb * sizeof(size_t));
+        c.nbSymboles = 0;
+        for (size_t k = 0; k < c.flot.nb; k++)
+        {
+            if (c.flot.type[k] == IDENTIFIER || c.flot.type[k] == NOMBRE)
+                c.symboles[c.nbSymboles++] = k;
+        }
+        size_t nbSymboles = c.nbSymboles;
+        double ajout = mesurer(phaseAjout, &c, 1, 5);
+        double recherche = mesurer(phaseRecherche, &c, 1, 5);
+        double analyse = mesurer(phaseAnalyse, &c, 1, 5);
+
+        double mos = c.src.longueur / lexeur * 1e3;
+        double jetons = c.flot.nb / lexeur * 1e9;
+        double nsAjout = nbSymboles ? ajout / nbSymboles : 0;
+        double nsRecherche = nbSymboles ? recherche / nbSymboles : 0;
+        double jetonsLL1 = c.flot.nb / analyse * 1e9;
+        printf("%-16s %10.1f %12.3g %12.1f %12.1f %12.3g\n", noms[i], mos, jetons, nsAjout, nsRecherche, jetonsLL1);
+        ecrireMesure("suite", noms[i], "lexical_analyzer", mos, "Mo/s");
+        ecrireMesure("suite", noms[i], "lexical_analyzer", jetons, "jetons/s");
+        ecrireMesure("suite", noms[i], "ajoutSymbole", nsAjout, "ns/op");
+        ecrireMesure("suite", noms[i], "chercherSymbole", nsRecherche, "ns/op");
+        ecrireMesure("suite", noms[i], "syn_analyzer", jetonsLL1, "jetons/s");
+
+        free(c.symboles);
+        libererPile(&c.stack);
+        libererFlot(&c.flot);
+        libererTS(&c.table);
+        free(corpus);
+    }
+}
+
+// Coût de la reconnaissance des mots clés par jeton identificateur : recherche
+// dans une TS qui contient aussi les mots clés (ancienne méthode) ou hachage parfait
+void benchmarkMotsCles()
+{
+    const char *noms[] = {"alpha", "beta", "if", "compteur", "indice", "while", "valeurMaximale",
+                          "x", "return", "resultatIntermediaire", "y", "mod", "gamma", "delta"};
+    const int nbNoms = sizeof(noms) / sizeof(noms[0]);
+    const int n = 10000000;
+    int longueurs[sizeof(noms) / sizeof(noms[0])];
+
+    TS table;
+    initialiserTS(&table);
+    for (int i = 0; i < NB_CASES_MOTS_CLES; i++)
+    {
+        if (motsCles[i].longueur > 0)
+            ajoutSymbole(&table, motsCles[i].texte, motsCles[i].longueur, MOTCLES);
+    }
+    for (int i = 0; i < nbNoms; i++)
+    {
+        longueurs[i] = strlen(noms[i]);
+        ajoutSymbole(&table, noms[i], longueurs[i], IDENTIFIER);
+    }
+
+    int trouves = 0;
+    double t0 = maintenantNs();
+    for (int k = 0; k < n; k++)
+    {
+        int id = chercherSymbole(&table, noms[k % nbNoms], longueurs[k % nbNoms]);
+        trouves += id != -1 && table.entries[id].type == MOTCLES;
+    }
+    double t1 = maintenantNs();
+    for (int k = 0; k < n; k++)
+    {
+        trouves += chercherMotCle(noms[k % nbNoms], longueurs[k % nbNoms]) != -1;
+    }
+    double t2 = maintenantNs();
+
+    printf("--- BENCHMARK MOTS CLES ---\n");
+    printf("recherche dans la TS: %5.2f ns/identificateur  hachage parfait: %5.2f ns/identificateur  (%d)\n",
+           (t1 - t0) / n, (t2 - t1) / n, trouves);
+    ecrireMesure("motscles", "identificateurs", "ts", (t1 - t0) / n, "ns/op");
+    ecrireMesure("motscles", "identificateurs", "hachage_parfait", (t2 - t1) / n, "ns/op");
+    libererTS(&table);
+}
+
+typedef struct
+{
+    MoteurAnalyse moteur;
+    FlotJetons *flot;
+    ParseStack *stack;
+    ArbreSyntaxe *arbre;
+    ResultatAnalyse resultat;
+} ContexteMoteur;
+
+void phaseMoteur(void *contexte)
+{
+    ContexteMoteur *c = contexte;
+    size_t k;
+    StackElement x;
+    c->resultat = c->moteur(c->flot, c->stack, c->arbre, &k, &x);
+}
+
+// Jetons analysés par seconde (arbre construit) : LL(1) contre Pratt, sur des
+// expressions du langage commun aux deux moteurs
+void benchmarkMoteurs()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    const char *cas[] = {"chaines", "imbrication"};
+    char *corpus[] = {genererCorpusChaine(16 * 1024 * 1024), genererSuiteImbrication(8 * 1024 * 1024)};
+    const char *noms[] = {"ll1", "pratt"};
+    MoteurAnalyse moteurs[] = {analyserLL1, analyserPratt};
+
+    printf("--- BENCHMARK MOTEURS D'ANALYSE (arbre construit) ---\n");
+    for (int c = 0; c < 2; c++)
+    {
+        Source src;
+        sourceDepuisChaine(&src, corpus[c]);
+        TS table;
+        initialiserTS(&table);
+        FlotJetons flot;
+        initialiserFlot(&flot);
+        tokenize(&matrice, &src, &table, &flot, NULL);
+        ParseStack stack;
+        creerPile(&stack, PROFONDEUR_PILE_MAX);
+        ArbreSyntaxe arbre;
+        creerArbre(&arbre);
+
+        double debit[2];
+        printf("%-12s %9zu jetons", cas[c], flot.nb);
+        for (int m = 0; m < 2; m++)
+        {
+            ContexteMoteur contexte = {moteurs[m], &flot, &stack, &arbre, ANALYSE_REUSSIE};
+            double duree = mesurer(phaseMoteur, &contexte, 1, 5);
+            debit[m] = flot.nb / duree * 1e3; // millions de jetons par seconde
+            printf("  %s: %7.1f Mjetons/s (pile max %zu)%s", noms[m], debit[m], stack.profondeurMax,
+                   contexte.resultat == ANALYSE_REUSSIE ? "" : " ERREUR");
+            ecrireMesure("moteurs", cas[c], noms[m], debit[m], "Mjetons/s");
+        }
+        printf("  gain: x%.2f\n", debit[1] / debit[0]);
+
+        libererArbre(&arbre);
+        libererPile(&stack);
+        libererFlot(&flot);
+        libererTS(&table);
+        free(corpus[c]);
+    }
+}
+
+typedef struct
+{
+    CSRmatrice *matrice;
+    Source *src;
+    bool pipeline;
+    TS table;
+    FlotJetons flot;
+    ParseStack stack;
+    ArbreSyntaxe arbre;
+    ResultatAnalyse resultat;
+} ContextePipeline;
+
+void phasePipeline(void *contexte)
+{
+    ContextePipeline *c = contexte;
+    size_t k;
+    StackElement x;
+    libererTS(&c->table);
+    initialiserTS(&c->table);
+    c->flot.nb = 0;
+    if (c->pipeline)
+    {
+        c->resultat = analyserPipeline(c->matrice, c->src, &c->table, &c->flot, &c->stack, &c->arbre, &k, &x, NULL);
+    }
+    else
+    {
+        tokenize(c->matrice, c->src, &c->table, &c->flot, NULL);
+        c->resultat = analyserLL1(&c->flot, &c->stack, &c->arbre, &k, &x);
+    }
+}
+
+// Lexeur puis analyseur LL(1) (arbre construit) sur un seul thread, contre les
+// deux en pipeline sur deux threads
+void benchmarkPipeline()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    const int taille = 32 * 1024 * 1024;
+    const char *cas[] = {"chaines", "identificateurs", "commentaires"};
+    char *(*generateurs[])(int) = {genererCorpusChaine, genererSuiteIdentificateurs, genererSuiteCommentaires};
+
+    // Sur un seul coeur, les deux threads alternent : il n'y a rien à recouvrir
+    printf("--- BENCHMARK PIPELINE LEXEUR/ANALYSEUR (32 Mo, %ld coeurs) ---\n", sysconf(_SC_NPROCESSORS_ONLN));
+    for (int c = 0; c < 3; c++)
+    {
+        char *corpus = generateurs[c](taille);
+        Source src;
+        sourceDepuisChaine(&src, corpus);
+        ContextePipeline contexte;
+        contexte.matrice = &matrice;
+        contexte.src = &src;
+        initialiserTS(&contexte.table);
+        initialiserFlot(&contexte.flot);
+        creerPile(&contexte.stack, PROFONDEUR_PILE_MAX);
+        creerArbre(&contexte.arbre);
+
+        double durees[2];
+        for (int p = 0; p < 2; p++)
+        {
+            contexte.pipeline = p == 1;
+            durees[p] = mesurer(phasePipeline, &contexte, 1, 5);
+        }
+        printf("%-16s %9zu jetons  en ligne: %7.2f ms  pipeline: %7.2f ms  gain: x%.2f%s\n", cas[c],
+               contexte.flot.nb, durees[0] / 1e6, durees[1] / 1e6, durees[0] / durees[1],
+               contexte.resultat == ANALYSE_REUSSIE ? "" : " ERREUR");
+        ecrireMesure("pipeline", cas[c], "en_ligne", durees[0] / 1e6, "ms");
+        ecrireMesure("pipeline", cas[c], "pipeline", durees[1] / 1e6, "ms");
+
+        libererArbre(&contexte.arbre);
+        libererPile(&contexte.stack);
+        libererFlot(&contexte.flot);
+        libererTS(&contexte.table);
+        free(corpus);
+    }
+}
+
+// Nombres de 1 à 4 chiffres (beaucoup de répétitions)
+char *genererSuiteNombresCourts(int taille)
+{
+    char *corpus = malloc(taille + 1);
+    int pos = 0;
+    uint64_t graine = 3;
+    const uint64_t bornes[] = {10, 100, 1000, 10000};
+    while (pos < taille - 32)
+    {
+        uint64_t borne = bornes[aleatoire(&graine) % 4];
+        pos += sprintf(corpus + pos, "%" PRIu64 " * ", aleatoire(&graine) % borne);
+    }
+    pos += sprintf(corpus + pos, "0");
+    return corpus;
+}
+
+typedef struct
+{
+    const char *texte;
+    const FlotJetons *flot;
+    bool strtoll;
+    uint64_t somme;
+} ContexteNombres;
+
+// Conversion de tous les littéraux du flot, avec convertirNombre ou strtoll
+void phaseConversion(void *contexte)
+{
+    ContexteNombres *c = contexte;
+    uint64_t somme = 0;
+    for (size_t k = 0; k < c->flot->nb; k++)
+    {
+        if (c->flot->type[k] != NOMBRE)
+            continue;
+        const char *lexeme = c->texte + c->flot->debut[k];
+        int64_t valeur;
+        if (c->strtoll)
+            valeur = strtoll(lexeme, NULL, 10);
+        else
+            convertirNombre(lexeme, (int)c->flot->longueur[k], &valeur);
+        somme += (uint64_t)valeur;
+    }
+    c->somme = somme;
+}
+
+// Conversion des littéraux (SWAR contre strtoll) et coût du lexeur qui les convertit
+void benchmarkNombres()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    compilerMatrice(&matrice);
+
+    const int taille = 16 * 1024 * 1024;
+    const char *cas[] = {"courts", "longs"};
+    char *(*generateurs[])(int) = {genererSuiteNombresCourts, genererSuiteNombres};
+
+    printf("--- BENCHMARK CONVERSION DES NOMBRES (16 Mo) ---\n");
+    for (int c = 0; c < 2; c++)
+    {
+        char *corpus = generateurs[c](taille);
+        Source src;
+        sourceDepuisChaine(&src, corpus);
+        ContexteTokenize lexeur;
+        lexeur.matrice = &matrice;
+        lexeur.src = &src;
+        initialiserFlot(&lexeur.flot);
+        double lexage = mesurer(phaseTokenize, &lexeur, 1, 5);
+        size_t nbNombres = (lexeur.flot.nb + 1) / 2;
+
+        ContexteNombres conversion = {corpus, &lexeur.flot, false, 0};
+        double swar = mesurer(phaseConversion, &conversion, 1, 9);
+        uint64_t somme = conversion.somme;
+        conversion.strtoll = true;
+        double reference = mesurer(phaseConversion, &conversion, 1, 9);
+
+        printf("%-8s %9zu nombres  SWAR: %5.2f ns  strtoll: %5.2f ns  gain: x%.2f  lexeur: %5.2f ns/jeton%s\n",
+               cas[c], nbNombres, swar / nbNombres, reference / nbNombres, reference / swar,
+               lexage / lexeur.flot.nb, somme == conversion.somme ? "" : " ERREUR");
+        ecrireMesure("nombres", cas[c], "swar", swar / nbNombres, "ns/nombre");
+        ecrireMesure("nombres", cas[c], "strtoll", reference / nbNombres, "ns/nombre");
+        ecrireMesure("nombres", cas[c], "lexeur", lexage / lexeur.flot.nb, "ns/jeton");
+
+        libererFlot(&lexeur.flot);
+        free(corpus);
+    }
+}
+
+void *executerBoucleServeur(void *arg)
+{
+    executerServeur(arg);
+    return NULL;
+}
+
+// Une invocation complète du compilateur (expression d'exemple), sortie ignorée
+void phaseProcessus(void *contexte)
+{
+    (void)contexte;
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    char *arguments[] = {"compilateur", NULL};
+    pid_t pid;
+    if (posix_spawn(&pid, "/proc/self/exe", &actions, NULL, arguments, NULL) == 0)
+        waitpid(pid, NULL, 0);
+    posix_spawn_file_actions_destroy(&actions);
+}
+
+// Serveur résident : latences vues par le générateur de charge, comparées à une
+// invocation du compilateur par requête
+void benchmarkServeur()
+{
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    char chemin[64];
+    snprintf(chemin, sizeof(chemin), "/tmp/compilateur-bench-%d.sock", (int)getpid());
+    int nbOuvriers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    Serveur serveur;
+    if (!demarrerServeur(&serveur, &matrice, chemin, nbOuvriers))
+        return;
+    pthread_t boucle;
+    pthread_create(&boucle, NULL, executerBoucleServeur, &serveur);
+
+    printf("--- BENCHMARK SERVEUR (%d ouvriers, socket Unix) ---\n", nbOuvriers);
+    const int clients[] = {1, 4, 16};
+    char cas[32];
+    double p50Seul = 0;
+    for (int c = 0; c < 3; c++)
+    {
+        HistogrammeLatences latences;
+        uint64_t erreurs;
+        int nbRequetes = 40000 / clients[c];
+        double duree = chargerServeur(chemin, clients[c], nbRequetes, &latences, &erreurs);
+        double debit = (double)clients[c] * nbRequetes / (duree / 1e9);
+        double p50 = centileLatence(&latences, 0.50) / 1e3, p99 = centileLatence(&latences, 0.99) / 1e3;
+        if (c == 0)
+            p50Seul = p50;
+        printf("%2d clients  %8.0f requetes/s  p50: %7.1f us  p99: %7.1f us%s\n", clients[c], debit, p50, p99,
+               erreurs == 0 ? "" : " ERREUR");
+        snprintf(cas, sizeof(cas), "%d_clients", clients[c]);
+        ecrireMesure("serveur", cas, "debit", debit, "requetes/s");
+        ecrireMesure("serveur", cas, "p50", p50, "us");
+        ecrireMesure("serveur", cas, "p99", p99, "us");
+    }
+    demanderArret(&serveur);
+    pthread_join(boucle, NULL);
+    arreterServeur(&serveur);
+
+    double processus = mesurer(phaseProcessus, NULL, 2, 21) / 1e3;
+    printf("un processus par requete: %7.1f us  (x%.0f le p50 du serveur)\n", processus, processus / p50Seul);
+    ecrireMesure("serveur", "processus", "duree", processus, "us");
+}
+
+// Insertion puis recherche (succès et échecs) de n symboles distincts
+void benchmarkTS()
+{
+    const int tailles[3] = {1000, 100000, 10000000};
+
+    printf("--- BENCHMARK TABLE DES SYMBOLES ---\n");
+    for (int t = 0; t < 3; t++)
+    {
+        int n = tailles[t];
+        // Clés contiguës "v<k>" / "w<k>" (les secondes sont absentes de la table)
+        char *cles = malloc((size_t)n * 24);
+        int *debuts = malloc(((size_t)n * 2 + 1) * sizeof(int));
+        int pos = 0;
+        for (int k = 0; k < 2 * n; k++)
+        {
+            debuts[k] = pos;
+            pos += sprintf(cles + pos, "%c%x", k < n ? 'v' : 'w', (unsigned)(k % n) * 2654435761u);
+        }
+        debuts[2 * n] = pos;
+
+        TS table;
+        initialiserTS(&table);
+        double t0 = maintenantNs();
+        for (int k = 0; k < n; k++)
+            ajoutSymbole(&table, cles + debuts[k], debuts[k + 1] - debuts[k], IDENTIFIER);
+        double t1 = maintenantNs();
+        int trouves = 0;
+        for (int k = 0; k < n; k++)
+            trouves += chercherSymbole(&table, cles + debuts[k], debuts[k + 1] - debuts[k]) >= 0;
+        double t2 = maintenantNs();
+        for (int k = n; k < 2 * n; k++)
+            trouves += chercherSymbole(&table, cles + debuts[k], debuts[k + 1] - debuts[k]) >= 0;
+        double t3 = maintenantNs();
+
+        printf("%9d symboles  ajout: %6.1f ns/op  recherche: %6.1f ns/op  echec: %6.1f ns/op  (%d trouves, %u cases)\n",
+               n, (t1 - t0) / n, (t2 - t1) / n, (t3 - t2) / n, trouves, table.masque + 1);
+        char cas[32];
+        snprintf(cas, sizeof(cas), "%d", n);
+        ecrireMesure("ts", cas, "ajout", (t1 - t0) / n, "ns/op");
+        ecrireMesure("ts", cas, "recherche", (t2 - t1) / n, "ns/op");
+        ecrireMesure("ts", cas, "echec", (t3 - t2) / n, "ns/op");
+        libererTS(&table);
+        free(cles);
+        free(debuts);
+    }
+}
+
+// Reconstruction d'une table par insertion contre chargement d'un instantané,
+// puis recherches et ajouts dans la table chargée (copie privée des pages)
+void benchmarkInstantane()
+{
+    const int n = 1000000;
+    const char *chemin = "bench_ts.instantane";
+    printf("--- BENCHMARK INSTANTANE DE LA TS (%d symboles) ---\n", n);
+    char *cles = malloc((size_t)n * 2 * 12);
+    int *debuts = malloc(((size_t)n * 2 + 1) * sizeof(int));
+    int pos = 0;
+    for (int k = 0; k < 2 * n; k++)
+    {
+        debuts[k] = pos;
+        pos += sprintf(cles + pos, "%c%x", k < n ? 'v' : 'w', (unsigned)(k % n) * 2654435761u);
+    }
+    debuts[2 * n] = pos;
+
+    TS table;
+    initialiserTS(&table);
+    double t0 = maintenantNs();
+    for (int k = 0; k < n; k++)
+        ajoutSymbole(&table, cles + debuts[k], debuts[k + 1] - debuts[k], IDENTIFIER);
+    double t1 = maintenantNs();
+    bool sauve = sauvegarderTS(&table, chemin);
+    double t2 = maintenantNs();
+    libererTS(&table);
+    if (!sauve)
+    {
+        free(cles);
+        free(debuts);
+        return;
+    }
+
+    TS chargee;
+    double t3 = maintenantNs();
+    bool charge = chargerTS(&chargee, chemin);
+    double t4 = maintenantNs();
+    int trouves = 0;
+    for (int k = 0; charge && k < n; k++)
+        trouves += chercherSymbole(&chargee, cles + debuts[k], debuts[k + 1] - debuts[k]) == k;
+    double t5 = maintenantNs();
+    for (int k = n; charge && k < 2 * n; k++)
+        trouves += ajoutSymbole(&chargee, cles + debuts[k], debuts[k + 1] - debuts[k], IDENTIFIER) == k;
+    double t6 = maintenantNs();
+    if (charge)
+        libererTS(&chargee);
+
+    printf("reconstruction: %8.2f ms  sauvegarde: %8.2f ms  chargement: %8.2f ms (x%.1f)\n", (t1 - t0) / 1e6,
+           (t2 - t1) / 1e6, (t4 - t3) / 1e6, (t1 - t0) / (t4 - t3));
+    printf("apres chargement  recherche: %6.1f ns/op  ajout: %6.1f ns/op  (%d/%d identifiants stables)\n",
+           (t5 - t4) / n, (t6 - t5) / n, trouves, 2 * n);
+    ecrireMesure("instantane", "1000000", "reconstruction", (t1 - t0) / 1e6, "ms");
+    ecrireMesure("instantane", "1000000", "sauvegarde", (t2 - t1) / 1e6, "ms");
+    ecrireMesure("instantane", "1000000", "chargement", (t4 - t3) / 1e6, "ms");
+    ecrireMesure("instantane", "1000000", "recherche", (t5 - t4) / n, "ns/op");
+    ecrireMesure("instantane", "1000000", "ajout", (t6 - t5) / n, "ns/op");
+
+    // Un octet modifié dans l'arène doit faire rejeter l'instantané
+    int fd = open(chemin, O_RDWR);
+    struct stat info;
+    char octet = 0;
+    bool modifie = fd >= 0 && fstat(fd, &info) == 0 && pread(fd, &octet, 1, info.st_size - 2) == 1;
+    octet ^= 1;
+    modifie = modifie && pwrite(fd, &octet, 1, info.st_size - 2) == 1;
+    if (fd >= 0)
+        close(fd);
+    // chargerTS affiche son propre diagnostic : le verdict vient après, sur sa ligne
+    TS corrompue;
+    bool accepte = modifie && chargerTS(&corrompue, chemin);
+    if (accepte)
+        libererTS(&corrompue);
+    printf("instantane corrompu : %s\n", !modifie ? "non modifie" : accepte ? "accepte" : "rejete");
+    ecrireMesure("instantane", "corrompu", "rejete", modifie && !accepte, "booleen");
+    unlink(chemin);
+    free(cles);
+    free(debuts);
+}
+
+// Compilation de plusieurs fichiers : sans cache, cache vide (tous analysés et
+// écrits), cache plein (aucun analysé) et 1 fichier sur 8 modifié
+void benchmarkCache()
+{
+    const int nbFichiers = 64;
+    const int taille = 256 * 1024;
+    const char *sources = "bench_cache_sources";
+    const char *repertoire = "bench_cache";
+    printf("--- BENCHMARK CACHE DE COMPILATION (%d fichiers de %d Ko) ---\n", nbFichiers, taille / 1024);
+    mkdir(sources, 0755);
+    char **chemins = malloc(nbFichiers * sizeof(char *));
+    char *corpus = genererCorpusChaine(taille);
+    for (int f = 0; f < nbFichiers; f++)
+    {
+        chemins[f] = malloc(64);
+        snprintf(chemins[f], 64, "%s/f%d.txt", sources, f);
+        FILE *fichier = fopen(chemins[f], "w");
+        if (fichier == NULL)
+            return;
+        fprintf(fichier, "v%d + %s", f, corpus);
+        fclose(fichier);
+    }
+
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    const char *cas[4] = {"sans_cache", "froid", "chaud", "modifies"};
+    for (int c = 0; c < 4; c++)
+    {
+        if (c == 3)
+        {
+            for (int f = 0; f < nbFichiers; f += 8)
+            {
+                FILE *fichier = fopen(chemins[f], "w");
+                if (fichier == NULL)
+                    continue;
+                fprintf(fichier, "w%d + %s", f, corpus);
+                fclose(fichier);
+            }
+        }
+        TS table;
+        initialiserTS(&table);
+        StatsCache stats;
+        double t0 = maintenantNs();
+        compilerFichiers(&matrice, chemins, nbFichiers, c == 0 ? NULL : repertoire, MAX_ENTREES_CACHE, &table, false,
+                         &stats);
+        double duree = (maintenantNs() - t0) / 1e6;
+        printf("%-10s : %8.2f ms  (%zu trouves, %zu manques, %zu reussis, %d symboles)\n", cas[c], duree, stats.trouves,
+               stats.manques, stats.reussis, table.size);
+        ecrireMesure("cache", cas[c], "duree", duree, "ms");
+        libererTS(&table);
+    }
+
+    // Nettoyage : l'éviction à 0 entrée vide le cache
+    evincerCache(repertoire, 0);
+    rmdir(repertoire);
+    for (int f = 0; f < nbFichiers; f++)
+    {
+        unlink(chemins[f]);
+        free(chemins[f]);
+    }
+    rmdir(sources);
+    free(chemins);
+    free(corpus);
+}
+
+// Usage : compilateur [--dense] [--trace] [--pipeline] [--profondeur-max N] [fichier | -]   (- : lecture en flux sur stdin)
+//         compilateur --lexeur-parallele [--threads N] [--dense] fichier
+//         compilateur --lot [--threads N] [--dense] (fichier | -)   (une expression par ligne)
+//         compilateur [--cache repertoire [--cache-max N]] fichier...   (plusieurs fichiers, résultats en cache)
+//         + [--ts-charger instantane] [--ts-sauver instantane]   (TS reprise d'une compilation à l'autre)
+//         compilateur bench [suite|lexeur|motscles|pile|arbre|moteurs|pipeline|evaluation|jit|lot|parallele|incremental|ts|instantane|cache...]
+int main(int argc, char *argv[])
+{
+#ifdef COMPTEURS
+    atexit(ecrireCompteurs);
+#endif
+    CSRmatrice matrice;
+    initialiserMatrcie(&matrice);
+    const char *chemin = NULL;
+    bool modeLot = false;
+    bool lexeurParallele = false;
+    bool pipeline = false;
+    const char *instantaneCharge = NULL;
+    const char *instantaneSauve = NULL;
+    const char *repertoireCache = NULL;
+    size_t maxEntreesCache = MAX_ENTREES_CACHE;
+    char **chemins = malloc(argc * sizeof(char *));
+    int nbChemins = 0;
+    int nbThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *socketServeur = NULL;
+    const char *socketCharge = NULL;
+    int nbClients = 8;
+    int nbRequetes = 10000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "bench") == 0)
+        {
+            // bench [nom...] : tous les benchmarks, ou seulement ceux nommés
+            const char *noms[] = {"suite", "lexeur", "motscles", "pile", "arbre", "moteurs", "pipeline", "evaluation",
+                                  "jit", "lot", "parallele", "incremental", "ts", "instantane",
+                                  "cache", "utf8", "nombres", "serveur"};
+            void (*benchmarks[])(void) = {benchmarkSuite, benchmarkLexeur, benchmarkMotsCles, benchmarkPile,
+                                          benchmarkArbre, benchmarkMoteurs, benchmarkPipeline, benchmarkEvaluation,
+                                          benchmarkJIT, benchmarkLot,
+                                          benchmarkLexeurParallele, benchmarkIncremental, benchmarkTS,
+                                          benchmarkInstantane, benchmarkCache, benchmarkUTF8,
+                                          benchmarkNombres, benchmarkServeur};
+            const int nbBenchmarks = sizeof(noms) / sizeof(noms[0]);
+            sortieBench = fopen(FICHIER_BENCH, "w");
+            for (int b = 0; b < nbBenchmarks; b++)
+            {
+                bool choisi = i + 1 == argc;
+                for (int j = i + 1; j < argc; j++)
+                    choisi |= strcmp(argv[j], noms[b]) == 0;
+                if (choisi)
+                {
+                    benchmarks[b]();
+                    if (sortieBench != NULL)
+                        fflush(sortieBench);
+                }
+            }
+            if (sortieBench != NULL)
+            {
+                fclose(sortieBench);
+                printf("Resultats ecrits dans %s\n", FICHIER_BENCH);
+            }
+            return 0;
+        }
+        if (strcmp(argv[i], "--dense") == 0)
+        {
+            compilerMatrice(&matrice);
+        }
+        else if (strcmp(argv[i], "--profondeur-max") == 0 && i + 1 < argc)
+        {
+            profondeurPileMax = strtoull(argv[++i], NULL, 10);
+            if (profondeurPileMax < 2)
+                profondeurPileMax = 2;
+        }
+        else if (strcmp(argv[i], "--lexeur-parallele") == 0)
+        {
+            lexeurParallele = true;
+        }
+        else if (strcmp(argv[i], "--pipeline") == 0)
+        {
+            pipeline = true;
+        }
+        else if (strcmp(argv[i], "--pratt") == 0)
+        {
+            moteurAnalyse = analyserPratt;
+        }
+        else if (strcmp(argv[i], "--lot") == 0)
+        {
+            modeLot = true;
+        }
+        else if (strcmp(argv[i], "--ts-charger") == 0 && i + 1 < argc)
+        {
+            instantaneCharge = argv[++i];
+        }
+        else if (strcmp(argv[i], "--ts-sauver") == 0 && i + 1 < argc)
+        {
+            instantaneSauve = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            repertoireCache = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cache-max") == 0 && i + 1 < argc)
+        {
+            maxEntreesCache = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--serveur") == 0 && i + 1 < argc)
+        {
+            socketServeur = argv[++i];
+        }
+        else if (strcmp(argv[i], "--charge") == 0 && i + 1 < argc)
+        {
+            socketCharge = argv[++i];
+        }
+        else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc)
+        {
+            nbClients = atoi(argv[++i]);
+            if (nbClients < 1)
+                nbClients = 1;
+        }
+        else if (strcmp(argv[i], "--requetes") == 0 && i + 1 < argc)
+        {
+            nbRequetes = atoi(argv[++i]);
+            if (nbRequetes < 1)
+                nbRequetes = 1;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            nbThreads = atoi(argv[++i]);
+            if (nbThreads < 1)
+                nbThreads = 1;
+        }
+        else if (strcmp(argv[i], "--trace") == 0)
+        {
+#if NIVEAU_TRACE > 0
+            activerTrace();
+#else
+            printf("Traces retirees a la compilation (NIVEAU_TRACE=0)\n");
+#endif
+        }
+        else
+        {
+            chemin = argv[i];
+            chemins[nbChemins++] = argv[i];
+        }
+    }
+
+    if (socketServeur != NULL)
+    {
+        free(chemins);
+        Serveur serveur;
+        if (!demarrerServeur(&serveur, &matrice, socketServeur, nbThreads))
+            return 1;
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = noterSignalArret; // sans SA_RESTART : epoll_wait est interrompu
+        sigaction(SIGINT, &action, NULL);
+        sigaction(SIGTERM, &action, NULL);
+        printf("Serveur en ecoute sur %s (%d ouvriers)\n", socketServeur, nbThreads);
+        fflush(stdout);
+        executerServeur(&serveur);
+
+        TamponOctets bilan = {NULL, 0, 0};
+        ecrireLatences(&bilan, "analyser", &serveur.latences[0], false);
+        ecrireLatences(&bilan, "evaluer", &serveur.latences[1], false);
+        ecrireLatences(&bilan, "attente", &serveur.attente, false);
+        printf("\n%" PRIu64 " requetes, %" PRIu64 " trames invalides\n%.*s", serveur.requetes, serveur.invalides,
+               (int)bilan.taille, bilan.donnees);
+        free(bilan.donnees);
+        arreterServeur(&serveur);
+        return 0;
+    }
+    if (socketCharge != NULL)
+    {
+        free(chemins);
+        HistogrammeLatences latences;
+        uint64_t erreurs;
+        double duree = chargerServeur(socketCharge, nbClients, nbRequetes, &latences, &erreurs);
+        TamponOctets bilan = {NULL, 0, 0};
+        ecrireLatences(&bilan, "aller-retour", &latences, false);
+        printf("%d clients x %d requetes en %.1f ms : %.0f requetes/s, %" PRIu64 " erreurs\n%.*s", nbClients,
+               nbRequetes, duree / 1e6, (double)nbClients * nbRequetes / (duree / 1e9), erreurs, (int)bilan.taille,
+               bilan.donnees);
+        free(bilan.donnees);
+        return erreurs == 0 ? 0 : 1;
+    }
+
+    TS table;
+    if (instantaneCharge == NULL)
+        initialiserTS(&table);
+    else if (!chargerTS(&table, instantaneCharge))
+        return 1;
+
+    if (!modeLot && (nbChemins > 1 || repertoireCache != NULL))
+    {
+        StatsCache stats;
+        double t0 = maintenantNs();
+        compilerFichiers(&matrice, chemins, nbChemins, repertoireCache, maxEntreesCache, &table, true, &stats);
+        printf("%d fichiers, %zu reussis, %d symboles (%.1f ms)\n", nbChemins, stats.reussis, table.size,
+               (maintenantNs() - t0) / 1e6);
+        if (repertoireCache != NULL)
+            printf("cache: %zu trouves, %zu manques, %zu invalides, %zu evinces\n", stats.trouves, stats.manques,
+                   stats.invalides, stats.evinces);
+        bool sauve = instantaneSauve == NULL || sauvegarderTS(&table, instantaneSauve);
+        libererTS(&table);
+        free(chemins);
+        return sauve ? 0 : 1;
+    }
+    free(chemins);
+
+    if (modeLot)
+    {
+        if (chemin == NULL)
+        {
+            printf("Erreur: --lot attend un fichier ou -\n");
+            return 1;
+        }
+        Source src;
+        char *texte = NULL;
+        int64_t longueur;
+        if (strcmp(chemin, "-") == 0)
+        {
+            texte = lireTout(STDIN_FILENO, &longueur);
+            sourceDepuisChaine(&src, texte);
+        }
+        else if (!ouvrirFichier(&src, chemin))
+        {
+            return 1;
+        }
+        size_t nb;
+        ResultatLigne *resultats = analyserLot(&matrice, src.donnees, src.longueur, nbThreads, &table, &nb);
+        size_t reussies = 0;
+        for (size_t i = 0; i < nb; i++)
+        {
+            if (resultats[i].resultat == ANALYSE_REUSSIE)
+            {
+                reussies++;
+                printf("%zu ok\n", i + 1);
+            }
+            else
+            {
+                printf("%zu erreur au jeton %u\n", i + 1, resultats[i].jetonErreur + 1);
+            }
+            // Diagnostics du lexeur pour cette ligne, après son résultat
+            if (resultats[i].diagnostics != NULL)
+                fputs(resultats[i].diagnostics, stdout);
+        }
+        printf("%zu lignes, %zu reussies, %d symboles (%d threads)\n", nb, reussies, table.size, nbThreads);
+        libererResultats(resultats, nb);
+        fermerSource(&src);
+        free(texte);
+        bool sauve = instantaneSauve == NULL || sauvegarderTS(&table, instantaneSauve);
+        libererTS(&table);
+        return sauve ? 0 : 1;
+    }
+
+    Source src;
+    if (chemin == NULL)
+    {
+        const char *input = "10 + abc * (4 * 3) - alpha";
+        printf("Analyse de : %s\n", input);
+        sourceDepuisChaine(&src, input);
+    }
+    else if (strcmp(chemin, "-") == 0)
+    {
+        printf("Analyse de : <entree standard>\n");
+        ouvrirFlux(&src, STDIN_FILENO, TAILLE_FENETRE);
+    }
+    else
+    {
+        if (!ouvrirFichier(&src, chemin))
+            return 1;
+        printf("Analyse de : %s\n", chemin);
+    }
+
+    FlotJetons flot;
+    initialiserFlot(&flot);
+    TamponOctets diagnostics = {NULL, 0, 0};
+    if (lexeurParallele)
+    {
+        int64_t tranche = src.longueur / (4 * nbThreads) + 1;
+        tokenizeParallele(&matrice, &src, &table, &flot, nbThreads,
+                          tranche > TAILLE_TRANCHE_MIN ? tranche : TAILLE_TRANCHE_MIN, &diagnostics);
+    }
+    else if (!pipeline)
+    {
+        tokenize(&matrice, &src, &table, &flot, &diagnostics);
+    }
+    afficherDiagnostics(&diagnostics);
+    syn_analyzer(&flot, &src, &table, pipeline && !lexeurParallele ? &matrice : NULL, &diagnostics);
+    free(diagnostics.donnees);
+    if (traceActive)
+    {
+        afficherTrace(&flot, &src, &table);
+        free(trace.evenements);
+    }
+    libererFlot(&flot);
+    fermerSource(&src);
+
+    afficherTS(&table);
+    bool sauve = instantaneSauve == NULL || sauvegarderTS(&table, instantaneSauve);
+    libererTS(&table);
+    return sauve ? 0 : 1;
+}
@@ -0,0 +1,800 @@
+// Générateur de l'automate du lexeur : lit la spécification des jetons (une
+// expression régulière par classe de jetons), construit l'automate non
+// déterministe de Thompson, le déterminise par la construction des sous-ensembles,
+// le minimise par l'algorithme de Hopcroft et écrit les tables CSR dans un en-tête C.
+//
+// Usage : generateur_automate jetons.def automate.h
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_NFA 1024
+#define MAX_DFA 256
+#define MAX_REGLES 32
+#define NB_OCTETS 256
+#define MOTS_NFA (MAX_NFA / 64)
+
+// Ensemble d'octets
+typedef struct
+{
+    uint64_t bits[4];
+} Octets;
+
+#define contientOctet(e, o) (((e).bits[(o) >> 6] >> ((o) & 63)) & 1)
+#define ajouterOctet(e, o) ((e).bits[(o) >> 6] |= 1ull << ((o) & 63))
+
+// Etat de l'automate non déterministe : au plus deux transitions vides et une
+// transition sur un ensemble d'octets
+typedef struct
+{
+    int epsilon[2]; // -1 si absente
+    int cible;      // -1 si absente
+    Octets octets;
+    int regle;        // règle dont le fragment contient l'état, -1 pour l'état initial
+    bool acceptation; // fin du fragment de la règle
+} EtatNFA;
+
+typedef struct
+{
+    char nom[64];      // type de lexème (LexemeType) ou IGNORER
+    char terminal[64]; // terminal de la grammaire (Terminal), vide pour IGNORER
+    bool ignorer;
+    int classe; // première règle de même type et même terminal
+} Regle;
+
+typedef struct
+{
+    int debut;
+    int fin;
+} Fragment;
+
+EtatNFA nfa[MAX_NFA];
+int nbNFA = 0;
+Regle regles[MAX_REGLES];
+int nbRegles = 0;
+
+// Rang de chaque octet dans l'ordre d'apparition dans la spécification : les
+// colonnes d'une ligne CSR suivent cet ordre, ce qui place en tête les octets
+// que l'auteur de la spécification cite en premier
+int rang[NB_OCTETS];
+int prochainRang = 0;
+
+// --- EXPRESSIONS REGULIERES ---
+// Syntaxe : littéraux, \n \t \r \xHH et \c (c littéral), classes [a-z] et [^...],
+// '.', groupes, alternative '|', répétitions '*', '+', '?'. Le complément ([^...]
+// et '.') est pris dans tous les octets sauf le caractère nul, qui marque la fin de
+// l'entrée : les octets UTF-8 en font partie (le compilateur valide l'UTF-8 de
+// l'entrée avant le lexeur).
+
+typedef struct
+{
+    const char *p;
+    int regle;
+    bool erreur;
+} Analyseur;
+
+int nouvelEtat(int regle)
+{
+    if (nbNFA == MAX_NFA)
+    {
+        printf("Erreur: automate non deterministe trop grand (%d etats)\n", MAX_NFA);
+        exit(1);
+    }
+    EtatNFA *e = &nfa[nbNFA];
+    memset(e, 0, sizeof(EtatNFA));
+    e->epsilon[0] = e->epsilon[1] = -1;
+    e->cible = -1;
+    e->regle = regle;
+    return nbNFA++;
+}
+
+void ajouterEpsilon(int de, int vers)
+{
+    if (nfa[de].epsilon[1] != -1)
+    {
+        printf("Erreur: plus de deux transitions vides depuis l'etat %d\n", de);
+        exit(1);
+    }
+    nfa[de].epsilon[nfa[de].epsilon[0] == -1 ? 0 : 1] = vers;
+}
+
+void citerOctet(int o)
+{
+    if (rang[o] < 0)
+    {
+        rang[o] = prochainRang++;
+    }
+}
+
+Fragment fragmentOctets(Analyseur *a, Octets octets)
+{
+    Fragment f = {nouvelEtat(a->regle), nouvelEtat(a->regle)};
+    nfa[f.debut].cible = f.fin;
+    nfa[f.debut].octets = octets;
+    return f;
+}
+
+Octets complementOctets(Octets e)
+{
+    Octets c = {{0}};
+    for (int o = 1; o < NB_OCTETS; o++)
+    {
+        if (!contientOctet(e, o))
+            ajouterOctet(c, o);
+    }
+    return c;
+}
+
+int hexa(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Lit un octet (éventuellement échappé) ; -1 en cas d'erreur
+int lireOctet(Analyseur *a)
+{
+    unsigned char c = (unsigned char)*a->p++;
+    if (c != '\\')
+        return c;
+    c = (unsigned char)*a->p++;
+    switch (c)
+    {
+    case 'n':
+        return '\n';
+    case 't':
+        return '\t';
+    case 'r':
+        return '\r';
+    case 'x':
+    {
+        int h = hexa(a->p[0]), l = h >= 0 ? hexa(a->p[1]) : -1;
+        if (l < 0)
+            return -1;
+        a->p += 2;
+        return h * 16 + l;
+    }
+    case '\0':
+        return -1;
+    default:
+        return c;
+    }
+}
+
+Fragment analyserAlternative(Analyseur *a);
+
+Fragment analyserClasse(Analyseur *a)
+{
+    Octets e = {{0}};
+    bool complement = *a->p == '^';
+    if (complement)
+        a->p++;
+    while (*a->p != ']' && *a->p != '\0' && !a->erreur)
+    {
+        int bas = lireOctet(a);
+        int haut = bas;
+        if (a->p[0] == '-' && a->p[1] != ']' && a->p[1] != '\0')
+        {
+            a->p++;
+            haut = lireOctet(a);
+        }
+        if (bas <= 0 || haut < bas)
+        {
+            a->erreur = true;
+            break;
+        }
+        for (int o = bas; o <= haut; o++)
+        {
+            citerOctet(o);
+            ajouterOctet(e, o);
+        }
+    }
+    if (*a->p != ']')
+    {
+        a->erreur = true;
+    }
+    else
+    {
+        a->p++;
+    }
+    return fragmentOctets(a, complement ? complementOctets(e) : e);
+}
+
+Fragment analyserAtome(Analyseur *a)
+{
+    Fragment f;
+    if (*a->p == '(')
+    {
+        a->p++;
+        f = analyserAlternative(a);
+        if (*a->p != ')')
+            a->erreur = true;
+        else
+            a->p++;
+        return f;
+    }
+    if (*a->p == '[')
+    {
+        a->p++;
+        return analyserClasse(a);
+    }
+    if (*a->p == '.')
+    {
+        a->p++;
+        Octets vide = {{0}};
+        return fragmentOctets(a, complementOctets(vide));
+    }
+    int o = lireOctet(a);
+    if (o <= 0)
+    {
+        a->erreur = true;
+        o = 1;
+    }
+    citerOctet(o);
+    Octets e = {{0}};
+    ajouterOctet(e, o);
+    return fragmentOctets(a, e);
+}
+
+Fragment analyserRepetition(Analyseur *a)
+{
+    Fragment f = analyserAtome(a);
+    while (*a->p == '*' || *a->p == '+' || *a->p == '?')
+    {
+        char op = *a->p++;
+        Fragment r = {nouvelEtat(a->regle), nouvelEtat(a->regle)};
+        ajouterEpsilon(r.debut, f.debut);
+        ajouterEpsilon(f.fin, r.fin);
+        if (op != '+')
+            ajouterEpsilon(r.debut, r.fin); // zéro occurrence
+        if (op != '?')
+            ajouterEpsilon(f.fin, f.debut); // occurrences suivantes
+        f = r;
+    }
+    return f;
+}
+
+Fragment analyserConcatenation(Analyseur *a)
+{
+    Fragment f = {nouvelEtat(a->regle), -1};
+    f.fin = f.debut;
+    while (*a->p != '\0' && *a->p != '|' && *a->p != ')' && !a->erreur)
+    {
+        Fragment suite = analyserRepetition(a);
+        ajouterEpsilon(f.fin, suite.debut);
+        f.fin = suite.fin;
+    }
+    return f;
+}
+
+Fragment analyserAlternative(Analyseur *a)
+{
+    Fragment f = analyserConcatenation(a);
+    while (*a->p == '|' && !a->erreur)
+    {
+        a->p++;
+        Fragment autre = analyserConcatenation(a);
+        Fragment choix = {nouvelEtat(a->regle), nouvelEtat(a->regle)};
+        ajouterEpsilon(choix.debut, f.debut);
+        ajouterEpsilon(choix.debut, autre.debut);
+        ajouterEpsilon(f.fin, choix.fin);
+        ajouterEpsilon(autre.fin, choix.fin);
+        f = choix;
+    }
+    return f;
+}
+
+// Lit un nom (lettres, chiffres, '_') suivi de blancs ; false s'il est vide ou trop long
+bool lireNom(char **p, char *nom)
+{
+    int n = 0;
+    while (isalnum((unsigned char)(*p)[n]) || (*p)[n] == '_')
+        n++;
+    if (n == 0 || n >= 64)
+        return false;
+    memcpy(nom, *p, n);
+    nom[n] = '\0';
+    *p += n;
+    while (**p == ' ' || **p == '\t')
+        (*p)++;
+    return true;
+}
+
+// Lit la spécification : une règle par ligne, "TYPE TERMINAL expression" ou
+// "IGNORER expression" ; les lignes vides et celles qui commencent par '#' sont
+// ignorées. En cas d'égalité de longueur,
+// la première règle l'emporte. Les règles IGNORER (blancs, commentaires) reviennent
+// à l'état initial : le lexème commence après elles.
+bool lireSpecification(const char *chemin, int initial)
+{
+    FILE *f = fopen(chemin, "r");
+    if (f == NULL)
+    {
+        printf("Erreur: impossible d'ouvrir %s\n", chemin);
+        return false;
+    }
+    char ligne[1024];
+    int numero = 0;
+    int fourche = initial; // l'état initial mène à chaque règle par une chaîne de fourches
+    bool ok = true;
+    while (ok && fgets(ligne, sizeof(ligne), f) != NULL)
+    {
+        numero++;
+        ligne[strcspn(ligne, "\r\n")] = '\0';
+        char *p = ligne;
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (*p == '\0' || *p == '#')
+            continue;
+
+        if (nbRegles == MAX_REGLES)
+        {
+            printf("Erreur: %s:%d : plus de %d regles\n", chemin, numero, MAX_REGLES);
+            ok = false;
+            break;
+        }
+        Regle *r = &regles[nbRegles];
+        r->terminal[0] = '\0';
+        bool nomValide = lireNom(&p, r->nom);
+        r->ignorer = nomValide && strcmp(r->nom, "IGNORER") == 0;
+        if (!nomValide || (!r->ignorer && !lireNom(&p, r->terminal)))
+        {
+            printf("Erreur: %s:%d : type ou terminal de regle invalide\n", chemin, numero);
+            ok = false;
+            break;
+        }
+        r->classe = nbRegles;
+        for (int autre = 0; autre < nbRegles; autre++)
+        {
+            if (strcmp(regles[autre].nom, r->nom) == 0 && strcmp(regles[autre].terminal, r->terminal) == 0)
+            {
+                r->classe = autre;
+                break;
+            }
+        }
+
+        Analyseur a = {p, nbRegles, false};
+        Fragment frag = analyserAlternative(&a);
+        if (a.erreur || *a.p != '\0' || *p == '\0')
+        {
+            printf("Erreur: %s:%d : expression invalide pres de '%s'\n", chemin, numero, a.p);
+            ok = false;
+            break;
+        }
+        int suivante = nouvelEtat(-1);
+        ajouterEpsilon(fourche, frag.debut);
+        ajouterEpsilon(fourche, suivante);
+        fourche = suivante;
+        if (r->ignorer)
+            ajouterEpsilon(frag.fin, initial);
+        else
+            nfa[frag.fin].acceptation = true;
+        nbRegles++;
+    }
+    fclose(f);
+    if (ok && nbRegles == 0)
+    {
+        printf("Erreur: %s ne contient aucune regle\n", chemin);
+        ok = false;
+    }
+    return ok;
+}
+
+// --- CONSTRUCTION DES SOUS-ENSEMBLES ---
+
+typedef struct
+{
+    uint64_t mots[MOTS_NFA];
+} EnsembleNFA;
+
+EnsembleNFA sousEnsembles[MAX_DFA];
+int transitionsDFA[MAX_DFA + 1][NB_OCTETS]; // -1 : pas de transition
+int nbDFA = 0;
+
+void fermeture(EnsembleNFA *e)
+{
+    int pile[MAX_NFA];
+    int nb = 0;
+    for (int s = 0; s < nbNFA; s++)
+    {
+        if ((e->mots[s >> 6] >> (s & 63)) & 1)
+            pile[nb++] = s;
+    }
+    while (nb > 0)
+    {
+        int s = pile[--nb];
+        for (int k = 0; k < 2; k++)
+        {
+            int t = nfa[s].epsilon[k];
+            if (t >= 0 && !((e->mots[t >> 6] >> (t & 63)) & 1))
+            {
+                e->mots[t >> 6] |= 1ull << (t & 63);
+                pile[nb++] = t;
+            }
+        }
+    }
+}
+
+int etatDFA(const EnsembleNFA *e)
+{
+    for (int d = 0; d < nbDFA; d++)
+    {
+        if (memcmp(&sousEnsembles[d], e, sizeof(EnsembleNFA)) == 0)
+            return d;
+    }
+    if (nbDFA == MAX_DFA)
+    {
+        printf("Erreur: automate deterministe trop grand (%d etats)\n", MAX_DFA);
+        exit(1);
+    }
+    sousEnsembles[nbDFA] = *e;
+    return nbDFA++;
+}
+
+void determiniser(int initial)
+{
+    EnsembleNFA e;
+    memset(&e, 0, sizeof(e));
+    e.mots[initial >> 6] |= 1ull << (initial & 63);
+    fermeture(&e);
+    etatDFA(&e);
+
+    for (int d = 0; d < nbDFA; d++) // nbDFA grandit pendant le parcours
+    {
+        for (int o = 0; o < NB_OCTETS; o++)
+        {
+            EnsembleNFA suivant;
+            memset(&suivant, 0, sizeof(suivant));
+            bool vide = true;
+            for (int s = 0; s < nbNFA; s++)
+            {
+                if (((sousEnsembles[d].mots[s >> 6] >> (s & 63)) & 1) && nfa[s].cible >= 0 &&
+                    contientOctet(nfa[s].octets, o))
+                {
+                    int t = nfa[s].cible;
+                    suivant.mots[t >> 6] |= 1ull << (t & 63);
+                    vide = false;
+                }
+            }
+            if (vide)
+            {
+                transitionsDFA[d][o] = -1;
+                continue;
+            }
+            fermeture(&suivant);
+            transitionsDFA[d][o] = etatDFA(&suivant);
+        }
+    }
+}
+
+// Règle acceptée par un état de l'automate déterministe (la première), -1 sinon ;
+// les règles de même type et même terminal sont confondues
+int regleAcceptee(int d)
+{
+    int meilleure = -1;
+    for (int s = 0; s < nbNFA; s++)
+    {
+        if (((sousEnsembles[d].mots[s >> 6] >> (s & 63)) & 1) && nfa[s].acceptation &&
+            (meilleure == -1 || nfa[s].regle < meilleure))
+            meilleure = nfa[s].regle;
+    }
+    return meilleure >= 0 ? regles[meilleure].classe : -1;
+}
+
+// Etat au milieu d'une règle IGNORER (commentaire commencé) : aucun jeton n'y est
+// possible et l'état initial n'y est pas atteint
+bool etatIgnore(int d, int initial)
+{
+    for (int s = 0; s < nbNFA; s++)
+    {
+        if ((sousEnsembles[d].mots[s >> 6] >> (s & 63)) & 1)
+        {
+            if (s == initial || nfa[s].regle < 0 || !regles[nfa[s].regle].ignorer)
+                return false;
+        }
+    }
+    return true;
+}
+
+// --- MINIMISATION (HOPCROFT) ---
+// L'automate est complété par un état puits (indice nbDFA). La partition initiale
+// sépare les états par type et terminal acceptés et par appartenance à une règle IGNORER
+// (le lexeur abandonne le texte d'un commentaire commencé) ; chaque bloc retiré de
+// la liste de travail découpe les autres selon leurs prédécesseurs.
+
+int bloc[MAX_DFA + 1];
+int nbBlocs = 0;
+
+void minimiser(int initial)
+{
+    int nb = nbDFA + 1;
+    int puits = nbDFA;
+    int cle[MAX_DFA + 1];
+    for (int o = 0; o < NB_OCTETS; o++)
+    {
+        transitionsDFA[puits][o] = puits;
+    }
+    for (int d = 0; d < nbDFA; d++)
+    {
+        for (int o = 0; o < NB_OCTETS; o++)
+        {
+            if (transitionsDFA[d][o] == -1)
+                transitionsDFA[d][o] = puits;
+        }
+        cle[d] = (regleAcceptee(d) + 1) * 2 + etatIgnore(d, initial);
+    }
+    cle[puits] = 0;
+
+    // Partition initiale
+    int cleBloc[MAX_DFA + 1];
+    for (int d = 0; d < nb; d++)
+    {
+        int b = 0;
+        while (b < nbBlocs && cleBloc[b] != cle[d])
+            b++;
+        if (b == nbBlocs)
+            cleBloc[nbBlocs++] = cle[d];
+        bloc[d] = b;
+    }
+
+    int travail[2 * (MAX_DFA + 1)];
+    bool enTravail[MAX_DFA + 1] = {false};
+    int nbTravail = 0;
+    for (int b = 0; b < nbBlocs; b++)
+    {
+        travail[nbTravail++] = b;
+        enTravail[b] = true;
+    }
+
+    while (nbTravail > 0)
+    {
+        int a = travail[--nbTravail];
+        enTravail[a] = false;
+        bool dansA[MAX_DFA + 1];
+        for (int d = 0; d < nb; d++)
+            dansA[d] = bloc[d] == a;
+
+        for (int o = 0; o < NB_OCTETS; o++)
+        {
+            // X : états dont la transition sur o mène dans A
+            bool dansX[MAX_DFA + 1];
+            for (int d = 0; d < nb; d++)
+                dansX[d] = dansA[transitionsDFA[d][o]];
+
+            int nbBlocsAvant = nbBlocs;
+            for (int y = 0; y < nbBlocsAvant; y++)
+            {
+                int avec = 0, sans = 0;
+                for (int d = 0; d < nb; d++)
+                {
+                    if (bloc[d] == y)
+                    {
+                        if (dansX[d])
+                            avec++;
+                        else
+                            sans++;
+                    }
+                }
+                if (avec == 0 || sans == 0)
+                    continue;
+
+                // Y se sépare : Y \ X devient un nouveau bloc
+                int nouveau = nbBlocs++;
+                for (int d = 0; d < nb; d++)
+                {
+                    if (bloc[d] == y && !dansX[d])
+                        bloc[d] = nouveau;
+                }
+                if (enTravail[y])
+                {
+                    travail[nbTravail++] = nouveau;
+                    enTravail[nouveau] = true;
+                }
+                else
+                {
+                    int plusPetit = avec <= sans ? y : nouveau;
+                    travail[nbTravail++] = plusPetit;
+                    enTravail[plusPetit] = true;
+                }
+            }
+        }
+    }
+}
+
+// --- ECRITURE ---
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        printf("Usage: %s jetons.def automate.h\n", argv[0]);
+        return 1;
+    }
+    for (int o = 0; o < NB_OCTETS; o++)
+        rang[o] = -1;
+
+    int initial = nouvelEtat(-1);
+    if (!lireSpecification(argv[1], initial))
+        return 1;
+    for (int o = 0; o < NB_OCTETS; o++)
+    {
+        if (rang[o] < 0)
+            rang[o] = prochainRang++;
+    }
+    // Octets dans l'ordre de la spécification
+    int ordre[NB_OCTETS];
+    for (int o = 0; o < NB_OCTETS; o++)
+        ordre[rang[o]] = o;
+
+    determiniser(initial);
+    minimiser(initial);
+
+    // Numérotation en largeur depuis l'état initial (0) ; le bloc puits disparaît
+    int puits = bloc[nbDFA];
+    int numero[MAX_DFA + 1];
+    int representant[MAX_DFA + 1];
+    for (int b = 0; b < nbBlocs; b++)
+    {
+        numero[b] = -1;
+        representant[b] = -1;
+    }
+    for (int d = 0; d < nbDFA; d++)
+    {
+        if (representant[bloc[d]] == -1)
+            representant[bloc[d]] = d;
+    }
+    int file[MAX_DFA + 1];
+    int nbEtats = 0;
+    numero[bloc[0]] = nbEtats;
+    file[nbEtats++] = bloc[0];
+    for (int i = 0; i < nbEtats; i++)
+    {
+        int d = representant[file[i]];
+        for (int k = 0; k < NB_OCTETS; k++)
+        {
+            int b = bloc[transitionsDFA[d][ordre[k]]];
+            if (b != puits && numero[b] == -1)
+            {
+                numero[b] = nbEtats;
+                file[nbEtats++] = b;
+            }
+        }
+    }
+
+    // Etats de l'automate minimal : type accepté, appartenance à une règle IGNORER
+    // (la même pour tous les états d'un bloc, par la partition initiale)
+    int regleEtat[MAX_DFA];
+    uint64_t ignores = 0;
+    for (int i = 0; i < nbEtats; i++)
+    {
+        int d = representant[file[i]];
+        regleEtat[i] = regleAcceptee(d);
+        if (etatIgnore(d, initial))
+        {
+            if (i >= 64)
+            {
+                printf("Erreur: l'etat %d d'une regle IGNORER ne tient pas dans le masque\n", i);
+                return 1;
+            }
+            ignores |= 1ull << i;
+        }
+    }
+
+    // Sauts par blocs du lexeur : les blancs dans l'état initial, et le corps de
+    // commentaire (tout octet sauf '*' et '\0' boucle sur l'état)
+    const char blancs[] = " \t\n\r";
+    int d0 = representant[file[0]];
+    for (int k = 0; blancs[k] != '\0'; k++)
+    {
+        if (bloc[transitionsDFA[d0][(unsigned char)blancs[k]]] != file[0])
+        {
+            printf("Erreur: les blancs doivent boucler sur l'etat initial (regle IGNORER [ \\t\\n\\r])\n");
+            return 1;
+        }
+    }
+    int corpsCommentaire = -1;
+    for (int i = 1; i < nbEtats && corpsCommentaire == -1; i++)
+    {
+        int d = representant[file[i]];
+        bool boucle = true;
+        for (int o = 1; o < NB_OCTETS && boucle; o++)
+        {
+            if (o != '*' && bloc[transitionsDFA[d][o]] != file[i])
+                boucle = false;
+        }
+        if (boucle)
+            corpsCommentaire = i;
+    }
+
+    FILE *f = fopen(argv[2], "w");
+    if (f == NULL)
+    {
+        printf("Erreur: impossible d'ecrire %s\n", argv[2]);
+        return 1;
+    }
+    int nbTransitions = 0;
+    fprintf(f, "// Genere par generateur_automate a partir de %s : ne pas modifier.\n", argv[1]);
+    fprintf(f, "// %d etats non deterministes, %d deterministes, %d apres minimisation.\n", nbNFA, nbDFA, nbEtats);
+    fprintf(f, "// Etats :");
+    for (int i = 0; i < nbEtats; i++)
+    {
+        if (regleEtat[i] >= 0)
+            fprintf(f, "%s %d=%s/%s", i ? "," : "", i, regles[regleEtat[i]].nom, regles[regleEtat[i]].terminal);
+        else
+            fprintf(f, "%s %d=%s", i ? "," : "", i, ((ignores >> i) & 1) ? "(ignore)" : "-");
+    }
+    fprintf(f, "\n\n#define NB_ETATS_AUTOMATE %d\n", nbEtats);
+    fprintf(f, "#define ETAT_INITIAL 0\n");
+    fprintf(f, "#define ETAT_CORPS_COMMENTAIRE %d // -1 : aucun\n", corpsCommentaire);
+    fprintf(f, "#define ETATS_IGNORES 0x%llxull // états au milieu d'une règle IGNORER\n\n",
+            (unsigned long long)ignores);
+
+    fprintf(f, "static const LexemeType typeEtatAutomate[NB_ETATS_AUTOMATE] = {");
+    for (int i = 0; i < nbEtats; i++)
+        fprintf(f, "%s%s", i ? ", " : "", regleEtat[i] >= 0 ? regles[regleEtat[i]].nom : "UNKNOWN");
+    fprintf(f, "};\n\n");
+
+    fprintf(f, "static const Terminal terminalEtatAutomate[NB_ETATS_AUTOMATE] = {");
+    for (int i = 0; i < nbEtats; i++)
+        fprintf(f, "%s%s", i ? ", " : "", regleEtat[i] >= 0 ? regles[regleEtat[i]].terminal : "TERM_ERREUR");
+    fprintf(f, "};\n\n");
+
+    fprintf(f, "static const int lignesAutomate[NB_ETATS_AUTOMATE + 1] = {0");
+    for (int i = 0; i < nbEtats; i++)
+    {
+        int d = representant[file[i]];
+        for (int k = 0; k < NB_OCTETS; k++)
+        {
+            if (bloc[transitionsDFA[d][ordre[k]]] != puits)
+                nbTransitions++;
+        }
+        fprintf(f, ", %d", nbTransitions);
+    }
+    fprintf(f, "};\n\n");
+
+    fprintf(f, "static const unsigned char colonnesAutomate[%d] = {", nbTransitions);
+    int n = 0;
+    for (int i = 0; i < nbEtats; i++)
+    {
+        int d = representant[file[i]];
+        for (int k = 0; k < NB_OCTETS; k++)
+        {
+            if (bloc[transitionsDFA[d][ordre[k]]] != puits)
+            {
+                fprintf(f, "%s%s%d", n ? "," : "", n % 24 == 0 ? "\n    " : "", ordre[k]);
+                n++;
+            }
+        }
+    }
+    fprintf(f, "};\n\n");
+
+    fprintf(f, "static const signed char ciblesAutomate[%d] = {", nbTransitions);
+    n = 0;
+    for (int i = 0; i < nbEtats; i++)
+    {
+        int d = representant[file[i]];
+        for (int k = 0; k < NB_OCTETS; k++)
+        {
+            int b = bloc[transitionsDFA[d][ordre[k]]];
+            if (b != puits)
+            {
+                fprintf(f, "%s%s%d", n ? "," : "", n % 32 == 0 ? "\n    " : "", numero[b]);
+                n++;
+            }
+        }
+    }
+    fprintf(f, "};\n");
+    fclose(f);
+
+    printf("%s : %d regles, %d etats NFA, %d etats DFA, %d etats minimaux, %d transitions\n", argv[2],
+           nbRegles, nbNFA, nbDFA, nbEtats, nbTransitions);
+    return 0;
+}